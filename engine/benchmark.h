@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness, used by the ecs_bench and physics_bench targets
+// Each case is run once per entity count to warm up, then for a fixed number of repetitions, each with a
+//	fresh setup and the same seed, so a workload is identical from run to run
+// Only the region passed to BenchmarkRun::measure is timed
+
+// Written by benchmarkKeep, at namespace scope so the stores count as a use
+template <typename T>
+inline volatile T _benchmarkSink;
+
+// Stores to a volatile, so results the benchmark doesn't otherwise use aren't optimised away
+template <typename T>
+void benchmarkKeep(T const& value) {
+	_benchmarkSink<T> = value;
+}
+
+struct BenchmarkRun {
+	uint64_t entityCount;
+	uint64_t seed;
+
+	uint64_t operations = 0;
+	double seconds = 0.0;
+	// Memory the case measured, reported alongside the timing if not 0
+	uint64_t bytes = 0;
+
+	// Times function, which performs operationCount operations
+	template <typename Function>
+	void measure(uint64_t operationCount, Function&& function) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		function();
+
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		operations = operationCount;
+	}
+
+	// Deterministic Fisher-Yates shuffle, std::shuffle isn't required to give the same order on every
+	//	standard library
+	template <typename T>
+	void shuffle(std::span<T> values) const {
+		std::mt19937_64 generator(seed);
+
+		for (uint64_t i = values.size(); i > 1; i--) {
+			std::swap(values[i - 1], values[generator() % i]);
+		}
+	}
+};
+
+struct BenchmarkResult {
+	std::string name;
+	uint64_t entityCount;
+	uint64_t operations;
+
+	// Nanoseconds per operation of each repetition, sorted
+	std::vector<double> samples;
+	uint64_t bytes = 0;
+
+	double min() const { return samples.front(); }
+	double max() const { return samples.back(); }
+	double median() const { return samples[samples.size() / 2]; }
+	double mean() const { return std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size()); }
+};
+
+struct BenchmarkSuite {
+	struct Case {
+		std::string name;
+		std::function<void(BenchmarkRun&)> function;
+		// Overrides the suite's entity counts, unless --entities was given
+		std::vector<uint64_t> entityCounts;
+	};
+
+	std::string name;
+	std::vector<uint64_t> entityCounts;
+	uint32_t repetitions = 10;
+	uint64_t seed = 0x5EED;
+	// Only cases whose name contains filter are run
+	std::string filter;
+	// Results are written here by runMain, if not empty
+	std::string jsonPath;
+	bool entityCountsFromArguments = false;
+
+	std::vector<Case> cases;
+	std::vector<BenchmarkResult> results;
+
+	// Reads --json path, --filter substring, --repetitions n and --entities n,n,...
+	// Returns false on an unknown option, a missing value, or a count that isn't a positive integer
+	bool parseArguments(int argc, char** argv) {
+		for (int i = 1; i < argc; i += 2) {
+			std::string_view option = argv[i];
+
+			if (i + 1 == argc) {
+				std::cerr << std::format("Missing value for {}\n", option);
+
+				return false;
+			}
+
+			std::string_view value = argv[i + 1];
+
+			if (option == "--json") {
+				jsonPath = value;
+			}
+			else if (option == "--filter") {
+				filter = value;
+			}
+			else if (option == "--repetitions") {
+				// Results are taken from the repetitions, so there must be at least one
+				if (!_parseCount(value, repetitions)) {
+					std::cerr << std::format("Invalid repetition count {}\n", value);
+
+					return false;
+				}
+			}
+			else if (option == "--entities") {
+				entityCounts.clear();
+				entityCountsFromArguments = true;
+
+				// Every comma separates two counts, so an empty count (e.g. a trailing comma) is rejected
+				for (uint64_t start = 0; start <= value.size();) {
+					uint64_t end = std::min(value.find(',', start), value.size());
+					uint64_t count = 0;
+
+					if (!_parseCount(value.substr(start, end - start), count)) {
+						std::cerr << std::format("Invalid entity count in {}\n", value);
+
+						return false;
+					}
+
+					entityCounts.push_back(count);
+					start = end + 1;
+				}
+			}
+			else {
+				std::cerr << std::format("Unknown option {}\n", option);
+
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Parses the whole of text as an integer greater than 0
+	template <typename T>
+	static bool _parseCount(std::string_view text, T& count) {
+		T parsed = 0;
+		std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), parsed);
+
+		if (result.ec != std::errc() || result.ptr != text.data() + text.size() || parsed == 0) return false;
+
+		count = parsed;
+
+		return true;
+	}
+
+	void add(std::string caseName, std::function<void(BenchmarkRun&)> function, std::vector<uint64_t> caseEntityCounts = {}) {
+		cases.push_back(Case{ std::move(caseName), std::move(function), std::move(caseEntityCounts) });
+	}
+
+	// Runs every case at every entity count, printing a line per result to log
+	void run(std::ostream& log) {
+		results.clear();
+
+		log << std::format("{:<28} {:>9} {:>12} {:>12} {:>12}\n", "case", "entities", "min ns/op", "median", "mean");
+
+		for (Case const& benchmarkCase : cases) {
+			if (benchmarkCase.name.find(filter) == std::string::npos) continue;
+
+			bool useCaseCounts = !benchmarkCase.entityCounts.empty() && !entityCountsFromArguments;
+
+			for (uint64_t entityCount : useCaseCounts ? benchmarkCase.entityCounts : entityCounts) {
+				BenchmarkResult result{ benchmarkCase.name, entityCount, 0, {} };
+
+				for (uint32_t i = 0; i <= repetitions; i++) {
+					BenchmarkRun run{ entityCount, seed };
+					benchmarkCase.function(run);
+
+					// First run only warms up the allocator and caches
+					if (i == 0) continue;
+
+					result.operations = run.operations;
+					result.bytes = run.bytes;
+					result.samples.push_back(run.seconds * 1e9 / static_cast<double>(std::max<uint64_t>(run.operations, 1)));
+				}
+
+				std::sort(result.samples.begin(), result.samples.end());
+
+				log << std::format("{:<28} {:>9} {:>12.2f} {:>12.2f} {:>12.2f}",
+					result.name, result.entityCount, result.min(), result.median(), result.mean());
+				log << (result.bytes == 0 ? "\n" : std::format(" {:>12} bytes\n", result.bytes));
+
+				results.push_back(std::move(result));
+			}
+		}
+	}
+
+	// Runs the suite and writes the results to jsonPath, returns the exit code for main
+	int runMain() {
+		run(std::cout);
+
+		if (jsonPath.empty()) return 0;
+
+		std::ofstream file(jsonPath);
+
+		if (!file) {
+			std::cerr << std::format("Couldn't open {}\n", jsonPath);
+
+			return 1;
+		}
+
+		writeJson(file);
+
+		return 0;
+	}
+
+	// Writes results as JSON, keyed by case name and entity count so runs can be diffed release to release
+	void writeJson(std::ostream& out) const {
+#ifdef NDEBUG
+		constexpr const char* build = "release";
+#else
+		constexpr const char* build = "debug";
+#endif
+
+		out << "{\n";
+		out << std::format("\t\"suite\": \"{}\",\n\t\"build\": \"{}\",\n\t\"repetitions\": {},\n\t\"seed\": {},\n", name, build, repetitions, seed);
+		out << "\t\"results\": [";
+
+		for (uint64_t i = 0; i < results.size(); i++) {
+			BenchmarkResult const& result = results[i];
+
+			out << (i == 0 ? "\n" : ",\n");
+			out << std::format("\t\t{{ \"name\": \"{}\", \"entities\": {}, \"operations\": {}, "
+				"\"ns_per_op\": {{ \"min\": {:.3f}, \"median\": {:.3f}, \"mean\": {:.3f}, \"max\": {:.3f} }}",
+				result.name, result.entityCount, result.operations, result.min(), result.median(), result.mean(), result.max());
+			out << (result.bytes == 0 ? " }" : std::format(", \"bytes\": {} }}", result.bytes));
+		}
+
+		out << "\n\t]\n}\n";
+	}
+};
\ No newline at end of file
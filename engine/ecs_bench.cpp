@@ -0,0 +1,629 @@
+// Standalone ECS benchmark suite, built as the ecs_bench target
+// Usage: ecs_bench [--json path] [--filter substring] [--repetitions n] [--entities n,n,...]
+// Build in release, debug builds keep the assertions and logging of the ECS
+
+#include "benchmark.h"
+
+#include "../vivium4/ecs/registry.h"
+#include "../vivium4/ecs/archetype.h"
+#include "../vivium4/serialiser/serialiser.h"
+
+#include <thread>
+#include <utility>
+
+using namespace Vivium;
+
+// 16 bytes, distinct per N so each instantiation gets its own pool
+template <uint64_t N>
+struct BenchComponent {
+	float values[4];
+};
+
+using BenchA = BenchComponent<0>;
+using BenchB = BenchComponent<1>;
+using BenchC = BenchComponent<2>;
+using BenchD = BenchComponent<3>;
+
+template <uint64_t... Is>
+void _addComponents(Registry& reg, Entity entity, std::index_sequence<Is...>) {
+	(reg.addComponent<BenchComponent<Is>>(entity, BenchComponent<Is>{ static_cast<float>(Is) }), ...);
+}
+
+template <uint64_t... Is>
+void _removeComponents(Registry& reg, Entity entity, std::index_sequence<Is...>) {
+	(reg.removeComponent<BenchComponent<Is>>(entity), ...);
+}
+
+std::vector<Entity> _createEntities(Registry& reg, uint64_t count) {
+	std::vector<Entity> entities(count);
+	reg.createMany(count, entities);
+
+	return entities;
+}
+
+// Every entity has A, three in four also have B
+std::vector<Entity> _populate(Registry& reg, uint64_t count) {
+	std::vector<Entity> entities = _createEntities(reg, count);
+
+	for (uint64_t i = 0; i < count; i++) {
+		reg.addComponent<BenchA>(entities[i], BenchA{ static_cast<float>(i) });
+
+		if (i % 4 != 0) reg.addComponent<BenchB>(entities[i], BenchB{ 1.0f, 2.0f, 3.0f, 4.0f });
+	}
+
+	return entities;
+}
+
+void _createDestroyCases(BenchmarkSuite& suite) {
+	suite.add("create", [](BenchmarkRun& run) {
+		Registry reg;
+
+		run.measure(run.entityCount, [&reg, &run] {
+			for (uint64_t i = 0; i < run.entityCount; i++) {
+				benchmarkKeep(reg.create());
+			}
+		});
+	});
+
+	suite.add("destroy", [](BenchmarkRun& run) {
+		Registry reg;
+		std::vector<Entity> entities = _populate(reg, run.entityCount);
+		run.shuffle(std::span<Entity>(entities));
+
+		run.measure(run.entityCount, [&reg, &entities] {
+			for (Entity entity : entities) {
+				reg.free(entity);
+			}
+		});
+	});
+
+	// Frees half the entities in random order and recreates them with a component, four times
+	suite.add("create_destroy_churn", [](BenchmarkRun& run) {
+		constexpr uint64_t rounds = 4;
+
+		Registry reg;
+		std::vector<Entity> entities = _populate(reg, run.entityCount);
+		run.shuffle(std::span<Entity>(entities));
+
+		uint64_t half = run.entityCount / 2;
+
+		run.measure(rounds * half * 2, [&reg, &entities, half] {
+			for (uint64_t round = 0; round < rounds; round++) {
+				// Alternate halves, so every round frees entities that are alive
+				uint64_t offset = (round % 2) * half;
+
+				for (uint64_t i = 0; i < half; i++) {
+					reg.free(entities[offset + i]);
+				}
+
+				for (uint64_t i = 0; i < half; i++) {
+					Entity entity = reg.create();
+					reg.addComponent<BenchA>(entity, BenchA{ static_cast<float>(i) });
+
+					entities[offset + i] = entity;
+				}
+			}
+		});
+	});
+}
+
+template <uint64_t K>
+void _addRemoveCases(BenchmarkSuite& suite) {
+	suite.add(std::format("add_components/{}", K), [](BenchmarkRun& run) {
+		Registry reg;
+		std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+
+		run.measure(run.entityCount * K, [&reg, &entities] {
+			for (Entity entity : entities) {
+				_addComponents(reg, entity, std::make_index_sequence<K>{});
+			}
+		});
+	});
+
+	suite.add(std::format("remove_components/{}", K), [](BenchmarkRun& run) {
+		Registry reg;
+		std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+
+		for (Entity entity : entities) {
+			_addComponents(reg, entity, std::make_index_sequence<K>{});
+		}
+
+		run.shuffle(std::span<Entity>(entities));
+
+		run.measure(run.entityCount * K, [&reg, &entities] {
+			for (Entity entity : entities) {
+				_removeComponents(reg, entity, std::make_index_sequence<K>{});
+			}
+		});
+	});
+}
+
+template <uint64_t... Ks>
+void _addRemoveCases(BenchmarkSuite& suite, std::index_sequence<Ks...>) {
+	(_addRemoveCases<Ks + 1>(suite), ...);
+}
+
+// Operations are the entities in the registry, not the entities matched
+template <OwnershipTag... Components, typename Function>
+void _iterationCase(BenchmarkSuite& suite, std::string const& name, Function iterate) {
+	suite.add(name, [iterate](BenchmarkRun& run) {
+		Registry reg;
+		View<Components...> view = reg.createView<Components...>();
+		_populate(reg, run.entityCount);
+
+		run.measure(run.entityCount, [&view, &iterate] {
+			iterate(view);
+		});
+	});
+}
+
+void _iterationCases(BenchmarkSuite& suite) {
+	auto iterateElements = [](auto& view) {
+		float sum = 0.0f;
+
+		for (auto& element : view) {
+			BenchA& a = element.template get<BenchA>();
+			BenchB const& b = element.template get<BenchB>();
+
+			a.values[0] += b.values[0];
+			sum += a.values[0];
+		}
+
+		benchmarkKeep(sum);
+	};
+
+	_iterationCase<Owned<BenchA>, Owned<BenchB>>(suite, "iterate_owned_each", [](auto& view) {
+		float sum = 0.0f;
+
+		view.each([&sum](std::span<BenchA> as, std::span<BenchB> bs, std::span<const Entity>) {
+			for (uint64_t i = 0; i < as.size(); i++) {
+				as[i].values[0] += bs[i].values[0];
+				sum += as[i].values[0];
+			}
+		});
+
+		benchmarkKeep(sum);
+	});
+
+	_iterationCase<Owned<BenchA>, Owned<BenchB>>(suite, "iterate_owned", iterateElements);
+	_iterationCase<Owned<BenchA>, Partial<BenchB>>(suite, "iterate_mixed", iterateElements);
+	_iterationCase<Partial<BenchA>, Partial<BenchB>>(suite, "iterate_partial", iterateElements);
+}
+
+void _accessCases(BenchmarkSuite& suite) {
+	suite.add("get_component_random", [](BenchmarkRun& run) {
+		Registry reg;
+		std::vector<Entity> entities = _populate(reg, run.entityCount);
+		run.shuffle(std::span<Entity>(entities));
+
+		run.measure(run.entityCount, [&reg, &entities] {
+			float sum = 0.0f;
+
+			for (Entity entity : entities) {
+				sum += reg.getComponent<BenchA>(entity).values[0];
+			}
+
+			benchmarkKeep(sum);
+		});
+	});
+
+	// Partitions pools that were filled (in random order) before the group existed
+	suite.add("create_group", [](BenchmarkRun& run) {
+		Registry reg;
+		std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+		run.shuffle(std::span<Entity>(entities));
+
+		for (uint64_t i = 0; i < entities.size(); i++) {
+			reg.addComponent<BenchA>(entities[i], BenchA{ static_cast<float>(i) });
+		}
+
+		run.shuffle(std::span<Entity>(entities));
+
+		for (uint64_t i = 0; i < entities.size(); i++) {
+			if (i % 4 != 0) reg.addComponent<BenchB>(entities[i], BenchB{});
+		}
+
+		run.measure(run.entityCount, [&reg] {
+			View<Owned<BenchA>, Owned<BenchB>> view = reg.createView<Owned<BenchA>, Owned<BenchB>>();
+
+			benchmarkKeep(view.groupMetadata->groupSize);
+		});
+	});
+}
+
+// Type-erased ComponentArray path (through the ComponentManager function table) against TypedComponentArray<T>
+void _componentArrayCases(BenchmarkSuite& suite) {
+	auto fillErased = [](ComponentArray& erased, uint64_t count) {
+		for (uint64_t i = 0; i < count; i++) {
+			BenchA component{ static_cast<float>(i) };
+			erased.push(static_cast<Entity>(i), &component);
+		}
+	};
+
+	auto fillTyped = [](TypedComponentArray<BenchA>& typed, uint64_t count) {
+		for (uint64_t i = 0; i < count; i++) {
+			typed.push(static_cast<Entity>(i), BenchA{ static_cast<float>(i) });
+		}
+	};
+
+	suite.add("pool_push_erased", [fillErased](BenchmarkRun& run) {
+		ComponentArray erased;
+		erased.manager = defaultComponentManager<BenchA>();
+
+		run.measure(run.entityCount, [&erased, &run, &fillErased] { fillErased(erased, run.entityCount); });
+	});
+
+	suite.add("pool_push_typed", [fillTyped](BenchmarkRun& run) {
+		TypedComponentArray<BenchA> typed;
+
+		run.measure(run.entityCount, [&typed, &run, &fillTyped] { fillTyped(typed, run.entityCount); });
+	});
+
+	suite.add("pool_iterate_erased", [fillErased](BenchmarkRun& run) {
+		ComponentArray erased;
+		erased.manager = defaultComponentManager<BenchA>();
+		fillErased(erased, run.entityCount);
+
+		run.measure(run.entityCount, [&erased] {
+			float sum = 0.0f;
+
+			for (uint64_t i = 0; i < erased.size; i++) {
+				BenchA& component = *reinterpret_cast<BenchA*>(&erased.dense[i * erased.manager.typeSize]);
+				component.values[1] += component.values[0];
+				sum += component.values[1];
+			}
+
+			benchmarkKeep(sum);
+		});
+	});
+
+	suite.add("pool_iterate_typed", [fillTyped](BenchmarkRun& run) {
+		TypedComponentArray<BenchA> typed;
+		fillTyped(typed, run.entityCount);
+
+		run.measure(run.entityCount, [&typed] {
+			float sum = 0.0f;
+			BenchA* components = typed.data();
+
+			for (uint64_t i = 0; i < typed.size; i++) {
+				components[i].values[1] += components[i].values[0];
+				sum += components[i].values[1];
+			}
+
+			benchmarkKeep(sum);
+		});
+	});
+
+	// Removes in creation order, so every removal swaps the back element forward
+	suite.add("pool_free_erased", [fillErased](BenchmarkRun& run) {
+		ComponentArray erased;
+		erased.manager = defaultComponentManager<BenchA>();
+		fillErased(erased, run.entityCount);
+
+		run.measure(run.entityCount, [&erased, &run] {
+			for (uint64_t i = 0; i < run.entityCount; i++) {
+				erased.free(static_cast<Entity>(i));
+			}
+		});
+	});
+
+	suite.add("pool_free_typed", [fillTyped](BenchmarkRun& run) {
+		TypedComponentArray<BenchA> typed;
+		fillTyped(typed, run.entityCount);
+
+		run.measure(run.entityCount, [&typed, &run] {
+			for (uint64_t i = 0; i < run.entityCount; i++) {
+				typed.free(static_cast<Entity>(i));
+			}
+		});
+	});
+}
+
+// Scaling of View::parallelForEach, one case per thread count from 1 to hardware_concurrency
+void _parallelCases(BenchmarkSuite& suite) {
+	constexpr uint64_t chunkSize = 4096;
+
+	uint32_t maximumThreads = std::max(std::thread::hardware_concurrency(), 1U);
+
+	for (uint32_t threads = 1; threads <= maximumThreads; threads++) {
+		suite.add(std::format("parallel_each/{}", threads), [threads](BenchmarkRun& run) {
+			JobSystem jobSystem(threads);
+			Registry reg;
+			View<Owned<BenchA>, Owned<BenchB>> view = reg.createView<Owned<BenchA>, Owned<BenchB>>();
+
+			std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+			std::vector<BenchA> as(run.entityCount, BenchA{});
+			std::vector<BenchB> bs(run.entityCount, BenchB{ 1.0f, 2.0f, 3.0f, 4.0f });
+
+			reg.addComponents<BenchA>(entities, as);
+			reg.addComponents<BenchB>(entities, bs);
+
+			run.measure(run.entityCount, [&view, &jobSystem] {
+				view.parallelForEach(jobSystem, chunkSize, [](std::span<BenchA> chunkAs, std::span<BenchB> chunkBs, std::span<const Entity>) {
+					for (uint64_t i = 0; i < chunkAs.size(); i++) {
+						for (uint64_t j = 0; j < 4; j++) {
+							chunkAs[i].values[j] += chunkBs[i].values[j] * 0.016f;
+						}
+					}
+				});
+			});
+		});
+	}
+}
+
+// Archetype storage against sparse-set storage, for entities sharing 4 components
+// The sparse-set view can only own 2 of the pools, the rest are random lookups
+void _archetypeCases(BenchmarkSuite& suite) {
+	auto addSparse = [](Registry& reg, std::span<const Entity> entities) {
+		for (Entity entity : entities) {
+			reg.addComponent<BenchA>(entity, BenchA{});
+			reg.addComponent<BenchB>(entity, BenchB{ 1.0f, 1.0f, 1.0f, 1.0f });
+			reg.addComponent<BenchC>(entity, BenchC{ 100.0f });
+			reg.addComponent<BenchD>(entity, BenchD{});
+		}
+	};
+
+	auto addArchetype = [](ArchetypeRegistry& reg, std::span<const Entity> entities) {
+		for (Entity entity : entities) {
+			reg.addComponent<BenchA>(entity, BenchA{});
+			reg.addComponent<BenchB>(entity, BenchB{ 1.0f, 1.0f, 1.0f, 1.0f });
+			reg.addComponent<BenchC>(entity, BenchC{ 100.0f });
+			reg.addComponent<BenchD>(entity, BenchD{});
+		}
+	};
+
+	suite.add("sparse_create_add4", [addSparse](BenchmarkRun& run) {
+		Registry reg;
+		// Only for the owning group, which the registry keeps
+		reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		std::vector<Entity> entities(run.entityCount);
+
+		run.measure(run.entityCount, [&reg, &entities, &addSparse] {
+			reg.createMany(entities.size(), entities);
+			addSparse(reg, entities);
+		});
+	});
+
+	suite.add("archetype_create_add4", [addArchetype](BenchmarkRun& run) {
+		ArchetypeRegistry reg;
+		ArchetypeView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>> view =
+			reg.createView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>>();
+		std::vector<Entity> entities(run.entityCount);
+
+		run.measure(run.entityCount, [&reg, &entities, &addArchetype] {
+			reg.createMany(entities.size(), entities);
+			addArchetype(reg, entities);
+		});
+	});
+
+	suite.add("sparse_iterate4", [addSparse](BenchmarkRun& run) {
+		Registry reg;
+		View<Owned<BenchA>, Owned<BenchB>> view = reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		addSparse(reg, _createEntities(reg, run.entityCount));
+
+		run.measure(run.entityCount, [&reg, &view] {
+			view.each([&reg](std::span<BenchA> as, std::span<BenchB> bs, std::span<const Entity> viewEntities) {
+				for (uint64_t i = 0; i < as.size(); i++) {
+					BenchC& c = reg.getComponent<BenchC>(viewEntities[i]);
+					BenchD& d = reg.getComponent<BenchD>(viewEntities[i]);
+
+					as[i].values[0] += bs[i].values[0] * c.values[0];
+					d.values[0] += 1.0f;
+				}
+			});
+		});
+	});
+
+	suite.add("archetype_iterate4", [addArchetype](BenchmarkRun& run) {
+		ArchetypeRegistry reg;
+		ArchetypeView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>> view =
+			reg.createView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>>();
+		std::vector<Entity> entities(run.entityCount);
+		reg.createMany(entities.size(), entities);
+		addArchetype(reg, entities);
+
+		run.measure(run.entityCount, [&view] {
+			view.each([](std::span<BenchA> as, std::span<BenchB> bs, std::span<BenchC> cs, std::span<BenchD> ds, std::span<const Entity>) {
+				for (uint64_t i = 0; i < as.size(); i++) {
+					as[i].values[0] += bs[i].values[0] * cs[i].values[0];
+					ds[i].values[0] += 1.0f;
+				}
+			});
+		});
+	});
+
+	suite.add("sparse_remove1", [addSparse](BenchmarkRun& run) {
+		Registry reg;
+		reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+		addSparse(reg, entities);
+
+		run.measure(run.entityCount, [&reg, &entities] {
+			for (Entity entity : entities) {
+				reg.removeComponent<BenchC>(entity);
+			}
+		});
+	});
+
+	suite.add("archetype_remove1", [addArchetype](BenchmarkRun& run) {
+		ArchetypeRegistry reg;
+		ArchetypeView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>> view =
+			reg.createView<Owned<BenchA>, Owned<BenchB>, Owned<BenchC>, Owned<BenchD>>();
+		std::vector<Entity> entities(run.entityCount);
+		reg.createMany(entities.size(), entities);
+		addArchetype(reg, entities);
+
+		run.measure(run.entityCount, [&reg, &entities] {
+			for (Entity entity : entities) {
+				reg.removeComponent<BenchC>(entity);
+			}
+		});
+	});
+}
+
+// Syncing every entity against syncing only those changed since the last pass, with 2% of entities moving
+void _changeDetectionCases(BenchmarkSuite& suite) {
+	constexpr uint64_t movedStride = 50;
+
+	auto syncCase = [](bool changedOnly) {
+		return [changedOnly](BenchmarkRun& run) {
+			Registry reg;
+			reg.trackChanges<BenchA>();
+
+			View<Owned<BenchA>, Owned<BenchB>> view = reg.createView<Owned<BenchA>, Owned<BenchB>>();
+			std::vector<Entity> entities = _populate(reg, run.entityCount);
+
+			uint32_t lastSync = reg.advanceTick();
+
+			for (uint64_t i = 0; i < entities.size(); i += movedStride) {
+				reg.getComponent<BenchA>(entities[i]).values[0] += 1.0f;
+			}
+
+			std::vector<BenchA> uploaded(run.entityCount);
+
+			run.measure(run.entityCount, [&view, &uploaded, changedOnly, lastSync] {
+				if (changedOnly) {
+					view.each<Changed<BenchA>>(lastSync, [&uploaded](ViewElement<Owned<BenchA>, Owned<BenchB>>& element) {
+						uploaded[getIdentifier(element.entity)] = element.read<BenchA>();
+					});
+				}
+				else {
+					view.each([&uploaded](std::span<BenchA> as, std::span<BenchB>, std::span<const Entity> viewEntities) {
+						for (uint64_t i = 0; i < as.size(); i++) {
+							uploaded[getIdentifier(viewEntities[i])] = as[i];
+						}
+					});
+				}
+			});
+		};
+	};
+
+	suite.add("sync_all", syncCase(false));
+	suite.add("sync_changed", syncCase(true));
+}
+
+template <uint64_t N>
+struct BenchBand {
+	float value;
+};
+
+// Sparse index memory with 40 component types, each added to its own band of entities, before and
+//	after removing every second type; operations are the additions and removals
+template <uint64_t... Ns>
+void _sparseMemoryCase(BenchmarkSuite& suite, std::string const& name, bool removeHalf, std::index_sequence<Ns...>) {
+	suite.add(name, [removeHalf](BenchmarkRun& run) {
+		constexpr uint64_t typeCount = sizeof...(Ns);
+
+		Registry reg;
+		std::vector<Entity> entities = _createEntities(reg, run.entityCount);
+
+		uint64_t bandStride = run.entityCount / typeCount;
+		uint64_t bandSize = bandStride * 2 / 5;
+		uint64_t operations = typeCount * bandSize + (removeHalf ? typeCount / 2 * bandSize : 0);
+
+		run.measure(operations, [&reg, &entities, bandStride, bandSize, removeHalf] {
+			([&] {
+				for (uint64_t i = Ns * bandStride; i < Ns * bandStride + bandSize; i++) {
+					reg.addComponent<BenchBand<Ns>>(entities[i], BenchBand<Ns>{ 0.0f });
+				}
+			} (), ...);
+
+			if (!removeHalf) return;
+
+			([&] {
+				if constexpr (Ns % 2 == 0) {
+					for (uint64_t i = Ns * bandStride; i < Ns * bandStride + bandSize; i++) {
+						reg.removeComponent<BenchBand<Ns>>(entities[i]);
+					}
+				}
+			} (), ...);
+		});
+
+		for (ComponentArray* pool : reg.componentPools) {
+			if (pool != nullptr) run.bytes += pool->sparseMemoryUsage();
+		}
+	});
+}
+
+// Whole-registry snapshot and restore through an in-memory buffer, against walking every entity
+//	and copying its components out one by one
+void _snapshotCases(BenchmarkSuite& suite) {
+	auto populate = [](Registry& reg, uint64_t count) {
+		std::vector<Entity> entities = _createEntities(reg, count);
+		std::vector<BenchA> as(count, BenchA{});
+		std::vector<BenchB> bs(count, BenchB{ 1.0f, 2.0f, 3.0f, 4.0f });
+
+		reg.addComponents<BenchA>(entities, as);
+		reg.addComponents<BenchB>(entities, bs);
+
+		return entities;
+	};
+
+	suite.add("snapshot", [populate](BenchmarkRun& run) {
+		Registry reg;
+		reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		populate(reg, run.entityCount);
+
+		SerialiserBufferInterface buffer;
+		Serialiser store(buffer);
+
+		// Warm up the buffer allocation, as repeated (e.g. rollback) snapshots would
+		reg.snapshot(store);
+		buffer.clear();
+
+		run.measure(run.entityCount, [&reg, &store] { reg.snapshot(store); });
+		run.bytes = buffer.bytes.size();
+	});
+
+	suite.add("restore", [populate](BenchmarkRun& run) {
+		Registry reg;
+		reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		populate(reg, run.entityCount);
+
+		SerialiserBufferInterface buffer;
+		Serialiser store(buffer);
+		reg.snapshot(store);
+
+		run.measure(run.entityCount, [&reg, &store] { reg.restore(store); });
+	});
+
+	suite.add("copy_per_entity", [populate](BenchmarkRun& run) {
+		Registry reg;
+		reg.createView<Owned<BenchA>, Owned<BenchB>>();
+		std::vector<Entity> entities = populate(reg, run.entityCount);
+
+		std::vector<BenchA> copiedAs(run.entityCount);
+		std::vector<BenchB> copiedBs(run.entityCount);
+
+		run.measure(run.entityCount, [&reg, &entities, &copiedAs, &copiedBs] {
+			for (uint64_t i = 0; i < entities.size(); i++) {
+				copiedAs[i] = reg.readComponent<BenchA>(entities[i]);
+				copiedBs[i] = reg.readComponent<BenchB>(entities[i]);
+			}
+		});
+	});
+}
+
+int main(int argc, char** argv) {
+	_logInit();
+
+	BenchmarkSuite suite;
+	suite.name = "ecs";
+	suite.entityCounts = { 10000, 100000, 1000000 };
+
+	if (!suite.parseArguments(argc, argv)) return 1;
+
+	_createDestroyCases(suite);
+	_addRemoveCases(suite, std::make_index_sequence<8>{});
+	_iterationCases(suite);
+	_accessCases(suite);
+	_componentArrayCases(suite);
+	_parallelCases(suite);
+	_archetypeCases(suite);
+	_changeDetectionCases(suite);
+	_sparseMemoryCase(suite, "sparse_memory_add", false, std::make_index_sequence<40>{});
+	_sparseMemoryCase(suite, "sparse_memory_remove_half", true, std::make_index_sequence<40>{});
+	_snapshotCases(suite);
+
+	return suite.runMain();
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "../vivium4/vivium4.h"
 
+#include <random>
+
 using namespace Vivium;
 
 void groupTest() {
@@ -65,4 +67,1390 @@ void groupTest() {
 	}
 
 	VIVIUM_LOG(LogSeverity::DEBUG, "Group test successful");
+}
+
+void parallelViewTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing parallel view test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	// Uneven count, so the last chunk is partial
+	constexpr uint64_t dummyCount = 100003;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		// Some entities not in group
+		if (i % 7 != 0) {
+			reg.addComponent<float>(entities[i], static_cast<float>(i));
+		}
+	}
+
+	std::vector<std::atomic<uint32_t>> visits(dummyCount);
+
+	JobSystem jobSystem(8);
+
+	view.parallelForEach(jobSystem, 1000, [&visits, &reg](std::span<int> ints, std::span<float> floats, std::span<const Entity> chunkEntities) {
+		for (uint64_t i = 0; i < ints.size(); i++) {
+			VIVIUM_ASSERT(ints[i] == static_cast<int>(floats[i]), "Packed arrays not aligned at {}", ints[i]);
+			VIVIUM_ASSERT(reg.getComponent<int>(chunkEntities[i]) == ints[i], "Entity didn't match packed component {}", ints[i]);
+
+			++visits[ints[i]];
+		}
+	});
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		uint32_t expected = i % 7 != 0;
+
+		VIVIUM_ASSERT(visits[i] == expected, "Entity {} visited {} times", i, visits[i].load());
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Parallel view test successful");
+}
+
+void commandBufferTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing command buffer test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	constexpr uint64_t dummyCount = 10000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+		reg.addComponent<float>(entities[i], static_cast<float>(i));
+	}
+
+	JobSystem jobSystem(4);
+	ParallelCommandBuffer commands(jobSystem);
+
+	// Structural changes while iterating: destroy odd entities, strip floats from multiples of 4,
+	//	and spawn a replacement for every destroyed entity
+	view.parallelForEach(jobSystem, 512, [&commands](std::span<int> ints, std::span<float>, std::span<const Entity> chunkEntities) {
+		EntityCommandBuffer& buffer = commands.local();
+
+		for (uint64_t i = 0; i < ints.size(); i++) {
+			if (ints[i] % 2 == 1) {
+				buffer.destroy(chunkEntities[i]);
+
+				PendingEntity spawned = buffer.create();
+				buffer.addComponent<int>(spawned, ints[i] + static_cast<int>(dummyCount));
+				buffer.addComponent<float>(spawned, 0.0f);
+			}
+			else if (ints[i] % 4 == 0) {
+				buffer.removeComponent<float>(chunkEntities[i]);
+			}
+		}
+	});
+
+	std::vector<Entity> spawned = commands.playback(reg);
+
+	VIVIUM_ASSERT(spawned.size() == dummyCount / 2, "Spawned {} entities", spawned.size());
+
+	std::vector<uint32_t> visits(dummyCount * 2);
+
+	view.each([&visits](std::span<int> ints, std::span<float>, std::span<const Entity>) {
+		for (int value : ints) {
+			++visits[value];
+		}
+	});
+
+	for (uint64_t i = 0; i < dummyCount * 2; i++) {
+		uint32_t expected = i < dummyCount ? i % 4 == 2 : i % 2 == 1;
+
+		VIVIUM_ASSERT(visits[i] == expected, "Entity {} visited {} times", i, visits[i]);
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Command buffer test successful");
+}
+
+void changeDetectionTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing change detection test");
+
+	Registry reg;
+
+	reg.trackChanges<int>();
+	reg.trackChanges<float>();
+
+	View<Owned<int>, Partial<float>> view = reg.createView<Owned<int>, Partial<float>>();
+
+	constexpr uint64_t dummyCount = 1000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+		reg.addComponent<float>(entities[i], 0.0f);
+	}
+
+	uint32_t lastTick = reg.advanceTick();
+
+	// Writes through every access path, reads through read<T>() shouldn't count
+	reg.getComponent<int>(entities[3]) = 3;
+	reg.markDirty<float>(entities[5]);
+	reg.readComponent<int>(entities[7]);
+
+	view.each<Added<int>>(0, [](ViewElement<Owned<int>, Partial<float>>& element) {
+		if (element.read<int>() == 11) {
+			element.get<float>() = 1.0f;
+		}
+	});
+
+	uint64_t changedInts = 0;
+	uint64_t changedFloats = 0;
+	uint64_t addedInts = 0;
+
+	view.each<Changed<int>>(lastTick, [&changedInts](ViewElement<Owned<int>, Partial<float>>& element) {
+		VIVIUM_ASSERT(element.read<int>() == 3, "Unexpected changed int {}", element.read<int>());
+
+		++changedInts;
+	});
+
+	view.each<Changed<float>>(lastTick, [&changedFloats](ViewElement<Owned<int>, Partial<float>>& element) {
+		int value = element.read<int>();
+		VIVIUM_ASSERT(value == 5 || value == 11, "Unexpected changed float {}", value);
+
+		++changedFloats;
+	});
+
+	view.each<Added<int>>(lastTick, [&addedInts](ViewElement<Owned<int>, Partial<float>>&) { ++addedInts; });
+
+	VIVIUM_ASSERT(changedInts == 1, "Changed {} ints", changedInts);
+	VIVIUM_ASSERT(changedFloats == 2, "Changed {} floats", changedFloats);
+	VIVIUM_ASSERT(addedInts == 0, "Added {} ints", addedInts);
+
+	// Everything was added since tick 0, including new entities that moved through the group
+	Entity late = reg.create();
+	reg.addComponent<int>(late, static_cast<int>(dummyCount));
+	reg.addComponent<float>(late, 0.0f);
+
+	addedInts = 0;
+	view.each<Added<int>>(0, [&addedInts](ViewElement<Owned<int>, Partial<float>>&) { ++addedInts; });
+	VIVIUM_ASSERT(addedInts == dummyCount + 1, "Added {} ints", addedInts);
+
+	addedInts = 0;
+	view.each<Added<int>>(lastTick, [&addedInts, late](ViewElement<Owned<int>, Partial<float>>& element) {
+		VIVIUM_ASSERT(element.entity == late, "Unexpected added entity");
+
+		++addedInts;
+	});
+	VIVIUM_ASSERT(addedInts == 1, "Added {} ints", addedInts);
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Change detection test successful");
+}
+
+void partialViewTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing partial view test");
+
+	Registry reg;
+
+	View<Owned<int>, Partial<float>> mixedView = reg.createView<Owned<int>, Partial<float>>();
+	View<Partial<float>, Partial<double>> partialView = reg.createView<Partial<float>, Partial<double>>();
+
+	constexpr uint64_t dummyCount = 1200;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+		if (i % 3 == 0) reg.addComponent<double>(entities[i], static_cast<double>(i));
+	}
+
+	uint64_t mixedCount = 0;
+
+	for (ViewElement<Owned<int>, Partial<float>>& element : mixedView) {
+		int value = element.get<int>();
+
+		VIVIUM_ASSERT(value % 2 == 0, "Invalid entity included in mixed view: {}", value);
+		VIVIUM_ASSERT(element.entity == entities[value], "Entity didn't match element {}", value);
+		VIVIUM_ASSERT(value == static_cast<int>(element.get<float>()), "Float part not equal for {}", value);
+
+		++mixedCount;
+	}
+
+	VIVIUM_ASSERT(mixedCount == dummyCount / 2, "Mixed view had {} elements", mixedCount);
+
+	uint64_t partialCount = 0;
+
+	for (ViewElement<Partial<float>, Partial<double>>& element : partialView) {
+		float value = element.get<float>();
+
+		VIVIUM_ASSERT(static_cast<uint64_t>(value) % 6 == 0, "Invalid entity included in partial view: {}", value);
+		VIVIUM_ASSERT(static_cast<double>(value) == element.get<double>(), "Double part not equal for {}", value);
+
+		++partialCount;
+	}
+
+	VIVIUM_ASSERT(partialCount == dummyCount / 6, "Partial view had {} elements", partialCount);
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Partial view test successful");
+}
+
+void entityVersionTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing entity version test");
+
+	Registry reg;
+
+	Entity first = reg.create();
+	reg.addComponent<int>(first, 1);
+	reg.free(first);
+
+	Entity second = reg.create();
+	reg.addComponent<int>(second, 2);
+
+	VIVIUM_ASSERT(getIdentifier(first) == getIdentifier(second), "Identifier wasn't recycled");
+	VIVIUM_ASSERT(!reg.valid(first) && reg.valid(second), "Stale handle was valid");
+	VIVIUM_ASSERT(!reg.componentPools[TypeGenerator::getIdentifier<int>()]->contains(first), "Stale handle had component");
+	VIVIUM_ASSERT(reg.getComponent<int>(second) == 2, "Recycled entity had wrong component");
+
+	// Going through the stale handle is fatal, counted here instead of terminating, and mustn't
+	//	reach the recycled entity
+	static uint64_t fatalCount = 0;
+	uint64_t events = 0;
+
+	reg.onDestroy<int>().connect([&events](Registry&, Entity) { ++events; });
+	reg.onUpdate<int>().connect([&events](Registry&, Entity) { ++events; });
+
+	setLogCallback([](LogContext const& context) {
+		if (context.severity == LogSeverity::FATAL) ++fatalCount;
+	});
+
+	reg.removeComponent<int>(first);
+	reg.markDirty<int>(first);
+
+	setLogCallback(_defaultLogCallback);
+
+#ifndef NDEBUG
+	VIVIUM_ASSERT(fatalCount == 2, "{} stale accesses reported", fatalCount);
+#endif
+	VIVIUM_ASSERT(events == 0, "Stale handle published {} events", events);
+	VIVIUM_ASSERT(reg.readComponent<int>(second) == 2, "Stale handle removed the recycled entity's component");
+
+	// Versions wrap around without ever producing the dead entity
+	Entity current = second;
+
+	for (uint64_t i = 0; i < ECS_VERSION_MAX + 10 && i < 100000; i++) {
+		reg.free(current);
+		current = reg.create();
+
+		VIVIUM_ASSERT(current != ECS_ENTITY_DEAD, "Created dead entity");
+		VIVIUM_ASSERT(getIdentifier(current) == getIdentifier(second), "Identifier wasn't recycled");
+	}
+
+	// Handles from before a clear stay invalid
+	std::vector<Entity> entities(100);
+	reg.createMany(entities.size(), entities);
+	reg.clear();
+
+	std::vector<Entity> recreated(100);
+	reg.createMany(recreated.size(), recreated);
+
+	for (Entity entity : entities) {
+		VIVIUM_ASSERT(!reg.valid(entity), "Handle from before clear was valid");
+	}
+
+	for (Entity entity : recreated) {
+		VIVIUM_ASSERT(reg.valid(entity), "Created entity wasn't valid");
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Entity version test successful");
+}
+
+
+void sortTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing sort test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	constexpr uint64_t dummyCount = 1000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		int value = static_cast<int>((i * 7919) % dummyCount);
+
+		reg.addComponent<int>(entities[i], static_cast<int>(value));
+		// Only half are in the group, the rest of the int pool is sorted separately
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(value));
+		reg.addComponent<double>(entities[i], static_cast<double>(value));
+	}
+
+	auto checkSorted = [&reg, &view](char const* name) {
+		std::span<int> ints = view.raw<int>();
+		std::span<float> floats = view.raw<float>();
+		std::span<const Entity> owned = view.entities();
+
+		for (uint64_t i = 0; i < ints.size(); i++) {
+			VIVIUM_ASSERT(i == 0 || ints[i - 1] <= ints[i], "{}: owned range wasn't sorted at {}", name, i);
+			VIVIUM_ASSERT(static_cast<float>(ints[i]) == floats[i], "{}: owned pools weren't permuted together at {}", name, i);
+			VIVIUM_ASSERT(reg.getComponent<int>(owned[i]) == ints[i], "{}: sparse set wasn't updated at {}", name, i);
+		}
+	};
+
+	view.sortBy<int>([](int a, int b) { return a < b; });
+	checkSorted("sortBy");
+
+	// Perturb a few values, and fix them up with the incremental sort
+	std::span<int> ints = view.raw<int>();
+	std::span<float> floats = view.raw<float>();
+	std::span<const Entity> perturbed = view.entities();
+
+	for (uint64_t i = 0; i + 1 < ints.size(); i += 50) {
+		std::swap(ints[i], ints[i + 1]);
+		std::swap(floats[i], floats[i + 1]);
+		std::swap(reg.getComponent<double>(perturbed[i]), reg.getComponent<double>(perturbed[i + 1]));
+	}
+
+	view.sortBy<int>([](int a, int b) { return a < b; }, SortMode::INSERTION);
+	checkSorted("insertion sortBy");
+
+	// Sorting the owning pool through the registry sorts the owned range and the remainder
+	reg.sort<int>([](int a, int b) { return a > b; });
+
+	ComponentArray* intPool = reg.componentPools[TypeGenerator::getIdentifier<int>()];
+	int* intData = static_cast<TypedComponentArray<int>*>(intPool)->data();
+	uint64_t groupSize = view.raw<int>().size();
+
+	for (uint64_t i = 0; i < intPool->size; i++) {
+		if (i != 0 && i != groupSize) VIVIUM_ASSERT(intData[i - 1] >= intData[i], "Int pool wasn't sorted at {}", i);
+
+		Entity entity = intPool->entities[i];
+		VIVIUM_ASSERT(reg.getComponent<double>(entity) == static_cast<double>(intData[i]), "Int pool entity mismatched at {}", i);
+		VIVIUM_ASSERT((i < groupSize) == reg.componentPools[TypeGenerator::getIdentifier<float>()]->contains(entity), "Entity left the group at {}", i);
+	}
+
+	// Unowned pool
+	reg.sort<double>([](double a, double b) { return a < b; });
+
+	ComponentArray* doublePool = reg.componentPools[TypeGenerator::getIdentifier<double>()];
+	double* doubleData = static_cast<TypedComponentArray<double>*>(doublePool)->data();
+
+	for (uint64_t i = 0; i < doublePool->size; i++) {
+		VIVIUM_ASSERT(i == 0 || doubleData[i - 1] <= doubleData[i], "Double pool wasn't sorted at {}", i);
+		VIVIUM_ASSERT(reg.getComponent<double>(doublePool->entities[i]) == doubleData[i], "Double pool sparse set wasn't updated at {}", i);
+	}
+
+	// Ordering by entity instead of component
+	view.sortByEntity([](Entity a, Entity b) { return getIdentifier(a) < getIdentifier(b); });
+
+	std::span<const Entity> owned = view.entities();
+
+	for (uint64_t i = 1; i < owned.size(); i++) {
+		VIVIUM_ASSERT(getIdentifier(owned[i - 1]) < getIdentifier(owned[i]), "Entities weren't sorted at {}", i);
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Sort test successful");
+}
+
+// Not trivially copyable, so snapshots go through its serialise hooks
+struct SnapshotName {
+	std::string name;
+};
+
+void serialiseWrite(SnapshotName const& component, Serialiser& store) {
+	uint64_t length = component.name.size();
+
+	store.writeBytes(sizeof(uint64_t), &length);
+	store.writeBytes(length, component.name.data());
+}
+
+void serialiseRead(SnapshotName* component, Serialiser& store) {
+	uint64_t length;
+
+	store.readBytes(sizeof(uint64_t), &length);
+	component->name.resize(length);
+	store.readBytes(length, component->name.data());
+}
+
+void snapshotTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing snapshot test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+	reg.trackChanges<double>();
+
+	constexpr uint64_t dummyCount = 2000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+		if (i % 3 == 0) reg.addComponent<double>(entities[i], static_cast<double>(i));
+		if (i % 5 == 0) reg.addComponent<SnapshotName>(entities[i], SnapshotName{ std::to_string(i) });
+	}
+
+	for (uint64_t i = 0; i < dummyCount; i += 7) {
+		reg.free(entities[i]);
+	}
+
+	SerialiserBufferInterface buffer;
+	Serialiser store(buffer);
+
+	reg.snapshot(store);
+
+	uint64_t groupSize = view.raw<int>().size();
+	uint32_t snapshotTick = reg.tick;
+
+	// Diverge from the snapshot
+	reg.advanceTick();
+
+	Entity created = reg.create();
+	reg.addComponent<float>(created, 1.0f);
+
+	for (uint64_t i = 1; i < dummyCount; i += 7) {
+		reg.free(entities[i]);
+	}
+
+	for (uint64_t i = 2; i < dummyCount; i += 7) {
+		reg.getComponent<int>(entities[i]) = -1;
+	}
+
+	auto checkRestored = [&entities](Registry& restored, char const* name) {
+		for (uint64_t i = 0; i < dummyCount; i++) {
+			Entity entity = entities[i];
+
+			VIVIUM_ASSERT(restored.valid(entity) == (i % 7 != 0), "{}: validity of {} wasn't restored", name, i);
+
+			if (!restored.valid(entity)) continue;
+
+			ComponentArray* floatPool = restored.componentPools[TypeGenerator::getIdentifier<float>()];
+			ComponentArray* doublePool = restored.componentPools[TypeGenerator::getIdentifier<double>()];
+			ComponentArray* namePool = restored.componentPools[TypeGenerator::getIdentifier<SnapshotName>()];
+
+			VIVIUM_ASSERT(restored.readComponent<int>(entity) == static_cast<int>(i), "{}: int of {} wasn't restored", name, i);
+			VIVIUM_ASSERT(floatPool->contains(entity) == (i % 2 == 0), "{}: float of {} wasn't restored", name, i);
+			VIVIUM_ASSERT(doublePool->contains(entity) == (i % 3 == 0), "{}: double of {} wasn't restored", name, i);
+			VIVIUM_ASSERT(namePool->contains(entity) == (i % 5 == 0), "{}: name of {} wasn't restored", name, i);
+
+			if (i % 2 == 0) VIVIUM_ASSERT(restored.readComponent<float>(entity) == static_cast<float>(i), "{}: float of {} was wrong", name, i);
+			if (i % 3 == 0) VIVIUM_ASSERT(restored.readComponent<double>(entity) == static_cast<double>(i), "{}: double of {} was wrong", name, i);
+			if (i % 5 == 0) VIVIUM_ASSERT(restored.readComponent<SnapshotName>(entity).name == std::to_string(i), "{}: name of {} was wrong", name, i);
+		}
+	};
+
+	buffer.readOffset = 0;
+	reg.restore(store);
+
+	checkRestored(reg, "rollback");
+
+	VIVIUM_ASSERT(!reg.valid(created), "Entity created after the snapshot was still valid");
+	VIVIUM_ASSERT(reg.tick == snapshotTick, "Tick wasn't restored");
+	VIVIUM_ASSERT(view.raw<int>().size() == groupSize, "Group size wasn't restored");
+
+	for (ViewElement<Owned<int>, Owned<float>>& element : view) {
+		VIVIUM_ASSERT(element.get<int>() % 2 == 0, "Invalid entity in restored group");
+		VIVIUM_ASSERT(static_cast<float>(element.get<int>()) == element.get<float>(), "Restored group wasn't aligned");
+	}
+
+	// Freed identifiers are recycled in the same order as before the restore
+	Entity recycled = reg.create();
+	VIVIUM_ASSERT(recycled == created, "Allocator state wasn't restored");
+
+	// Restoring into a fresh registry with the same pools and groups
+	Registry copy;
+
+	View<Owned<int>, Owned<float>> copyView = copy.createView<Owned<int>, Owned<float>>();
+	copy.registerComponent<double>();
+	copy.registerComponent<SnapshotName>();
+
+	buffer.readOffset = 0;
+	copy.restore(store);
+
+	checkRestored(copy, "copy");
+
+	VIVIUM_ASSERT(copyView.raw<int>().size() == groupSize, "Group size wasn't copied");
+	VIVIUM_ASSERT(copy.componentPools[TypeGenerator::getIdentifier<double>()]->isTracked(), "Tracking wasn't copied");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Snapshot test successful");
+}
+
+struct TagEnemy {};
+
+struct TagFrameState {
+	uint64_t frame = 0;
+	float deltaTime = 0.0f;
+};
+
+void tagTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing tag test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<TagEnemy>> view = reg.createView<Owned<int>, Owned<TagEnemy>>();
+
+	constexpr uint64_t dummyCount = 1000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		if (i % 4 == 0) reg.addComponent<TagEnemy>(entities[i], TagEnemy{});
+	}
+
+	for (uint64_t i = 0; i < dummyCount; i += 8) {
+		reg.removeComponent<TagEnemy>(entities[i]);
+	}
+
+	ComponentArray* tagPool = reg.componentPools[TypeGenerator::getIdentifier<TagEnemy>()];
+
+	VIVIUM_ASSERT(tagPool->dense == nullptr, "Tag pool allocated dense storage");
+	VIVIUM_ASSERT(tagPool->size == dummyCount / 8, "Tag pool had {} entities", tagPool->size);
+	VIVIUM_ASSERT(tagPool->denseMemoryUsage() == tagPool->capacity * sizeof(Entity), "Tag pool used {} dense bytes", tagPool->denseMemoryUsage());
+
+	uint64_t elementCount = 0;
+
+	for (ViewElement<Owned<int>, Owned<TagEnemy>>& element : view) {
+		VIVIUM_ASSERT(element.get<int>() % 8 == 4, "Invalid entity in tag view: {}", element.get<int>());
+
+		++elementCount;
+	}
+
+	VIVIUM_ASSERT(elementCount == dummyCount / 8, "Tag view had {} elements", elementCount);
+
+	// Tags get no span
+	view.each([](std::span<int> ints, std::span<const Entity> viewEntities) {
+		VIVIUM_ASSERT(ints.size() == viewEntities.size(), "Span sizes didn't match");
+
+		for (int value : ints) {
+			VIVIUM_ASSERT(value % 8 == 4, "Invalid entity in tag span: {}", value);
+		}
+	});
+
+	reg.free(entities[4]);
+	VIVIUM_ASSERT(view.entities().size() == dummyCount / 8 - 1, "Freed entity stayed in tag view");
+
+	// Singletons
+	VIVIUM_ASSERT(!reg.context.contains<TagFrameState>(), "Context had state before first access");
+
+	reg.ctx<TagFrameState>().frame = 10;
+	reg.ctx<TagFrameState>().deltaTime = 0.5f;
+
+	VIVIUM_ASSERT(reg.ctx<TagFrameState>().frame == 10 && reg.ctx<TagFrameState>().deltaTime == 0.5f, "Context state wasn't kept");
+
+	reg.context.emplace<TagFrameState>(TagFrameState{ 3, 1.0f });
+	VIVIUM_ASSERT(reg.ctx<TagFrameState>().frame == 3, "Context state wasn't replaced");
+
+	// Replacing with a copy of itself, the old value is only destroyed after the copy
+	reg.context.emplace<TagFrameState>(reg.ctx<TagFrameState>());
+	VIVIUM_ASSERT(reg.ctx<TagFrameState>().frame == 3 && reg.ctx<TagFrameState>().deltaTime == 1.0f, "Context state wasn't copied");
+
+	reg.context.erase<TagFrameState>();
+	VIVIUM_ASSERT(!reg.context.contains<TagFrameState>(), "Context state wasn't erased");
+	VIVIUM_ASSERT(reg.ctx<TagFrameState>().frame == 0, "Context state wasn't default constructed");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Tag test successful");
+}
+
+// Checks that the owned range of group is packed at the front of every owned pool, and holds
+//	exactly the entities matching it
+void _checkGroupPacked(Registry& reg, GroupMetadata* group, char const* name) {
+	ComponentArray* front = group->ownedPools.front();
+
+	for (uint64_t i = 0; i < front->size; i++) {
+		Entity entity = front->entities[i];
+		bool matches = reg.signatures.get(getIdentifier(entity)).includes(group->affectedComponents);
+
+		VIVIUM_ASSERT(matches == (i < group->groupSize), "{}: entity at {} was on the wrong side of the group", name, i);
+
+		if (i >= group->groupSize) continue;
+
+		for (ComponentArray* pool : group->ownedPools) {
+			VIVIUM_ASSERT(pool->entities[i] == entity, "{}: owned pools weren't aligned at {}", name, i);
+		}
+	}
+}
+
+void nestedGroupTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing nested group test");
+
+	constexpr uint64_t dummyCount = 1200;
+
+	// Inner group created first, and after the outer group
+	for (uint64_t innerFirst = 0; innerFirst < 2; innerFirst++) {
+		Registry reg;
+
+		std::vector<Entity> entities(dummyCount);
+		reg.createMany(dummyCount, entities);
+
+		for (uint64_t i = 0; i < dummyCount; i++) {
+			reg.addComponent<int>(entities[i], i);
+
+			if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+			if (i % 3 == 0) reg.addComponent<double>(entities[i], static_cast<double>(i));
+		}
+
+		View<Owned<int>, Owned<float>, Owned<double>> inner;
+		View<Owned<int>, Owned<float>> outer;
+		View<Owned<int>, Owned<float>, Owned<double>, Partial<char>> innermost;
+
+		if (innerFirst) {
+			inner = reg.createView<Owned<int>, Owned<float>, Owned<double>>();
+			outer = reg.createView<Owned<int>, Owned<float>>();
+			innermost = reg.createView<Owned<int>, Owned<float>, Owned<double>, Partial<char>>();
+		}
+		else {
+			outer = reg.createView<Owned<int>, Owned<float>>();
+			innermost = reg.createView<Owned<int>, Owned<float>, Owned<double>, Partial<char>>();
+			inner = reg.createView<Owned<int>, Owned<float>, Owned<double>>();
+		}
+
+		auto checkAll = [&reg, &outer, &inner, &innermost](char const* name) {
+			_checkGroupPacked(reg, outer.groupMetadata, name);
+			_checkGroupPacked(reg, inner.groupMetadata, name);
+			_checkGroupPacked(reg, innermost.groupMetadata, name);
+		};
+
+		checkAll("created");
+
+		VIVIUM_ASSERT(outer.raw<int>().size() == dummyCount / 2, "Outer group had {} entities", outer.raw<int>().size());
+		VIVIUM_ASSERT(inner.raw<int>().size() == dummyCount / 6, "Inner group had {} entities", inner.raw<int>().size());
+
+		for (uint64_t i = 0; i < dummyCount; i += 5) {
+			reg.addComponent<char>(entities[i], 'a');
+		}
+
+		checkAll("added char");
+
+		for (uint64_t i = 0; i < dummyCount; i += 4) {
+			if (i % 3 == 0) reg.removeComponent<double>(entities[i]);
+			else reg.addComponent<double>(entities[i], static_cast<double>(i));
+		}
+
+		checkAll("changed double");
+
+		for (uint64_t i = 0; i < dummyCount; i += 7) {
+			reg.free(entities[i]);
+		}
+
+		checkAll("freed");
+
+		std::vector<Entity> batch(300);
+		std::vector<int> ints(batch.size(), 1);
+		std::vector<float> floats(batch.size(), 2.0f);
+		std::vector<double> doubles(batch.size(), 3.0);
+
+		reg.createMany(batch.size(), batch);
+		reg.addComponents<double>(batch, doubles);
+		reg.addComponents<float>(batch, floats);
+		reg.addComponents<int>(batch, ints);
+
+		checkAll("batch");
+
+		// Sorting the outer group keeps the inner ranges at the front
+		outer.sortBy<int>([](int a, int b) { return a > b; });
+		checkAll("sorted outer");
+
+		reg.sort<float>([](float a, float b) { return a < b; });
+		checkAll("sorted pool");
+
+		// Destroying a group leaves the others intact
+		reg.destroyView(inner);
+		_checkGroupPacked(reg, outer.groupMetadata, "destroyed inner");
+		_checkGroupPacked(reg, innermost.groupMetadata, "destroyed inner");
+
+		reg.removeComponent<float>(entities[2]);
+		reg.addComponent<char>(entities[3], 'b');
+
+		_checkGroupPacked(reg, outer.groupMetadata, "after destroy");
+		_checkGroupPacked(reg, innermost.groupMetadata, "after destroy");
+
+		reg.destroyView(outer);
+		reg.destroyView(innermost);
+
+		VIVIUM_ASSERT(reg.groups.empty(), "Groups weren't destroyed");
+		VIVIUM_ASSERT(!reg.componentPools[TypeGenerator::getIdentifier<int>()]->isOwned(), "Pool was still owned");
+
+		// Pools are free to be owned by a group that wouldn't have nested
+		View<Owned<int>, Owned<double>> other = reg.createView<Owned<int>, Owned<double>>();
+		_checkGroupPacked(reg, other.groupMetadata, "recreated");
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Nested group test successful");
+}
+
+void signalTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing signal test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	std::vector<Entity> constructed;
+	std::vector<Entity> destroyed;
+	std::vector<Entity> updated;
+
+	reg.onConstruct<float>().connect([&constructed](Registry& registry, Entity entity) {
+		// Published after groups are updated
+		VIVIUM_ASSERT(registry.componentPools[TypeGenerator::getIdentifier<float>()]->contains(entity), "Constructed component wasn't added yet");
+
+		constructed.push_back(entity);
+	});
+
+	ComponentSignal::Connection destroyConnection = reg.onDestroy<float>().connect([&destroyed](Registry& registry, Entity entity) {
+		// Published before removal, so the component can still be read
+		VIVIUM_ASSERT(registry.readComponent<float>(entity) == static_cast<float>(getIdentifier(entity)), "Destroyed component wasn't readable");
+
+		destroyed.push_back(entity);
+	});
+
+	reg.onUpdate<float>().connect([&updated](Registry&, Entity entity) {
+		updated.push_back(entity);
+	});
+
+	constexpr uint64_t dummyCount = 100;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+	}
+
+	for (uint64_t i = 0; i < dummyCount / 2; i++) {
+		reg.addComponent<float>(entities[i], static_cast<float>(i));
+	}
+
+	std::vector<float> floats;
+
+	for (uint64_t i = dummyCount / 2; i < dummyCount; i++) {
+		floats.push_back(static_cast<float>(i));
+	}
+
+	reg.addComponents<float>(std::span<const Entity>(entities).subspan(dummyCount / 2), floats);
+
+	VIVIUM_ASSERT(constructed == entities, "Construct events didn't match added components");
+
+	reg.removeComponent<float>(entities[0]);
+	reg.free(entities[1]);
+	reg.free(entities[2]);
+	reg.removeComponent<int>(entities[3]);
+
+	VIVIUM_ASSERT(destroyed.size() == 3 && destroyed[0] == entities[0] && destroyed[1] == entities[1] && destroyed[2] == entities[2],
+		"Destroy events didn't match removed components");
+
+	reg.markDirty<float>(entities[4]);
+	VIVIUM_ASSERT(updated.size() == 1 && updated[0] == entities[4], "Update event wasn't published");
+
+	// Deferred signals queue events until flushed
+	reg.onDestroy<float>().disconnect(destroyConnection);
+	reg.onDestroy<float>().connect([&destroyed](Registry&, Entity entity) { destroyed.push_back(entity); });
+	reg.onDestroy<float>().setDeferred(true);
+	destroyed.clear();
+
+	reg.free(entities[5]);
+	reg.removeComponent<float>(entities[6]);
+
+	VIVIUM_ASSERT(destroyed.empty(), "Deferred events were delivered immediately");
+
+	reg.flushSignals();
+
+	VIVIUM_ASSERT(destroyed.size() == 2 && destroyed[0] == entities[5] && destroyed[1] == entities[6], "Deferred events weren't delivered in order");
+
+	reg.flushSignals();
+	VIVIUM_ASSERT(destroyed.size() == 2, "Deferred events were delivered twice");
+
+	VIVIUM_ASSERT(view.raw<float>().size() == dummyCount - 6, "Group was wrong after events");
+
+	// A listener that disconnects itself and connects enough listeners to reallocate the list,
+	//	changes take effect after the current event
+	ComponentSignal::Connection selfRemoving = 0;
+	uint64_t selfRemovingCalls = 0;
+	uint64_t laterCalls = 0;
+	uint64_t connectedCalls = 0;
+
+	selfRemoving = reg.onUpdate<float>().connect([&selfRemoving, &selfRemovingCalls, &connectedCalls](Registry& registry, Entity) {
+		ComponentSignal& signal = registry.onUpdate<float>();
+
+		++selfRemovingCalls;
+		signal.disconnect(selfRemoving);
+
+		for (uint64_t i = 0; i < 16; i++) {
+			signal.connect([&connectedCalls](Registry&, Entity) { ++connectedCalls; });
+		}
+	});
+
+	reg.onUpdate<float>().connect([&laterCalls](Registry&, Entity) { ++laterCalls; });
+
+	reg.markDirty<float>(entities[7]);
+	VIVIUM_ASSERT(selfRemovingCalls == 1 && laterCalls == 1 && connectedCalls == 0, "Listeners changed during delivery weren't deferred");
+
+	reg.markDirty<float>(entities[7]);
+	VIVIUM_ASSERT(selfRemovingCalls == 1 && laterCalls == 2 && connectedCalls == 16, "Listeners connected during delivery weren't added");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Signal test successful");
+}
+
+// Counts copies and live instances, to check components are constructed in place and relocated by moving
+struct EmplaceTracked {
+	inline static int64_t copies = 0;
+	inline static int64_t alive = 0;
+
+	std::vector<int> values;
+
+	EmplaceTracked() { ++alive; }
+	EmplaceTracked(uint64_t count, int value) : values(count, value) { ++alive; }
+	EmplaceTracked(EmplaceTracked const& other) : values(other.values) { ++alive; ++copies; }
+	EmplaceTracked(EmplaceTracked&& other) noexcept : values(std::move(other.values)) { ++alive; }
+	EmplaceTracked& operator=(EmplaceTracked const& other) { values = other.values; ++copies; return *this; }
+	EmplaceTracked& operator=(EmplaceTracked&& other) noexcept { values = std::move(other.values); return *this; }
+	~EmplaceTracked() { --alive; }
+};
+
+void emplaceTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing emplace test");
+
+	{
+		Registry reg;
+
+		View<Owned<EmplaceTracked>, Owned<int>> view = reg.createView<Owned<EmplaceTracked>, Owned<int>>();
+
+		constexpr uint64_t dummyCount = 500;
+		std::vector<Entity> entities(dummyCount);
+
+		reg.createMany(dummyCount, entities);
+
+		for (uint64_t i = 0; i < dummyCount; i++) {
+			EmplaceTracked& component = reg.emplace<EmplaceTracked>(entities[i], i % 7, static_cast<int>(i));
+
+			VIVIUM_ASSERT(component.values.size() == i % 7, "Emplaced component wasn't constructed from arguments");
+
+			if (i % 2 == 0) reg.emplace<int>(entities[i], static_cast<int>(i));
+		}
+
+		// Pool grew several times, and half the entities moved into the group
+		VIVIUM_ASSERT(EmplaceTracked::copies == 0, "Components were copied {} times", EmplaceTracked::copies);
+		VIVIUM_ASSERT(EmplaceTracked::alive == dummyCount, "{} components alive, expected {}", EmplaceTracked::alive, dummyCount);
+
+		for (uint64_t i = 0; i < dummyCount; i++) {
+			EmplaceTracked const& component = reg.readComponent<EmplaceTracked>(entities[i]);
+
+			VIVIUM_ASSERT(component.values.size() == i % 7, "Component of {} was lost", i);
+			VIVIUM_ASSERT(component.values.empty() || component.values.front() == static_cast<int>(i), "Component of {} was wrong", i);
+		}
+
+		EmplaceTracked& replaced = reg.replace<EmplaceTracked>(entities[3], 2, -1);
+		VIVIUM_ASSERT(replaced.values.size() == 2 && replaced.values[0] == -1, "Component wasn't replaced");
+
+		EmplaceTracked& existing = reg.getOrEmplace<EmplaceTracked>(entities[3], 10, 10);
+		VIVIUM_ASSERT(&existing == &replaced && existing.values.size() == 2, "getOrEmplace replaced an existing component");
+
+		Entity created = reg.create();
+		EmplaceTracked& emplaced = reg.getOrEmplace<EmplaceTracked>(created, 4, 4);
+		VIVIUM_ASSERT(emplaced.values.size() == 4, "getOrEmplace didn't emplace");
+
+		VIVIUM_ASSERT(EmplaceTracked::copies == 0, "Components were copied {} times", EmplaceTracked::copies);
+		VIVIUM_ASSERT(EmplaceTracked::alive == dummyCount + 1, "{} components alive, expected {}", EmplaceTracked::alive, dummyCount + 1);
+
+		VIVIUM_ASSERT(view.raw<int>().size() == dummyCount / 2, "Group had {} entities", view.raw<int>().size());
+	}
+
+	VIVIUM_ASSERT(EmplaceTracked::alive == 0, "{} components leaked", EmplaceTracked::alive);
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Emplace test successful");
+}
+
+void commandOrderTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing command order test");
+
+	Registry reg;
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	constexpr uint64_t dummyCount = 3000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		if (i % 3 != 2) reg.addComponent<float>(entities[i], static_cast<float>(i));
+	}
+
+	EntityCommandBuffer buffer;
+
+	// Replace the float of multiples of 3, remove it twice from the rest, and add then
+	//	immediately remove one on entities without a float
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		if (i % 3 == 0) {
+			buffer.removeComponent<float>(entities[i]);
+			buffer.addComponent<float>(entities[i], -static_cast<float>(i));
+		}
+		else if (i % 3 == 1) {
+			buffer.removeComponent<float>(entities[i]);
+			buffer.removeComponent<float>(entities[i]);
+		}
+		else {
+			buffer.addComponent<float>(entities[i], 1.0f);
+			buffer.removeComponent<float>(entities[i]);
+		}
+	}
+
+	buffer.playback(reg);
+
+	ComponentArray* floatPool = reg.componentPools[TypeGenerator::getIdentifier<float>()];
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		VIVIUM_ASSERT(floatPool->contains(entities[i]) == (i % 3 == 0), "Float of {} didn't follow recorded order", i);
+
+		if (i % 3 == 0) {
+			VIVIUM_ASSERT(reg.readComponent<float>(entities[i]) == -static_cast<float>(i), "Float of {} wasn't replaced", i);
+		}
+	}
+
+	VIVIUM_ASSERT(view.raw<int>().size() == dummyCount / 3, "Group had {} entities", view.raw<int>().size());
+
+	view.each([](std::span<int> ints, std::span<float> floats, std::span<const Entity>) {
+		for (uint64_t i = 0; i < ints.size(); i++) {
+			VIVIUM_ASSERT(floats[i] == -static_cast<float>(ints[i]), "Group arrays not aligned at {}", ints[i]);
+		}
+	});
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Command order test successful");
+}
+
+void duplicateAddTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing duplicate add test");
+
+	Registry reg;
+
+	reg.trackChanges<float>();
+
+	View<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+
+	constexpr uint64_t dummyCount = 1000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], i);
+
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+	}
+
+	uint64_t constructed = 0;
+
+	reg.onConstruct<float>().connect([&constructed](Registry&, Entity) { ++constructed; });
+
+	// Adding to an entity that already has the component is fatal, counted here instead of terminating,
+	//	as release builds (without logging) carry on with the rest of the batch
+	static uint64_t fatalCount = 0;
+
+	setLogCallback([](LogContext const& context) {
+		if (context.severity == LogSeverity::FATAL) ++fatalCount;
+	});
+
+	std::vector<float> floats(dummyCount, -1.0f);
+	reg.addComponents<float>(entities, floats);
+
+	// Single adds, the last component in the pool mustn't be stamped in place of the existing one
+	uint32_t lastTick = reg.advanceTick();
+
+	reg.addComponent<float>(entities[0], -2.0f);
+	reg.emplace<float>(entities[2], -2.0f);
+
+	setLogCallback(_defaultLogCallback);
+
+#ifndef NDEBUG
+	VIVIUM_ASSERT(fatalCount == dummyCount / 2 + 2, "{} duplicates reported", fatalCount);
+#endif
+	VIVIUM_ASSERT(constructed == dummyCount / 2, "{} construct events for {} added components", constructed, dummyCount / 2);
+
+	uint64_t added = 0;
+	view.each<Added<float>>(lastTick, [&added](ViewElement<Owned<int>, Owned<float>>&) { ++added; });
+	VIVIUM_ASSERT(added == 0, "{} floats reported added by duplicate adds", added);
+	VIVIUM_ASSERT(view.raw<int>().size() == dummyCount, "Group had {} entities", view.raw<int>().size());
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		float expected = i % 2 == 0 ? static_cast<float>(i) : -1.0f;
+
+		VIVIUM_ASSERT(reg.readComponent<float>(entities[i]) == expected, "Float of {} was overwritten", i);
+	}
+
+	view.each([](std::span<int> ints, std::span<float> floats, std::span<const Entity>) {
+		for (uint64_t i = 0; i < ints.size(); i++) {
+			float expected = ints[i] % 2 == 0 ? static_cast<float>(ints[i]) : -1.0f;
+
+			VIVIUM_ASSERT(floats[i] == expected, "Group arrays not aligned at {}", ints[i]);
+		}
+	});
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Duplicate add test successful");
+}
+
+void sharedComponentTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing shared component test");
+
+	Registry reg;
+
+	// Partial views aren't groups, so any number of them leaves every group slot free
+	std::vector<View<Partial<int>, Partial<float>>> partialViews;
+
+	for (uint64_t i = 0; i < ECS_GROUP_MAX + 8; i++) {
+		partialViews.push_back(reg.createView<Partial<int>, Partial<float>>());
+	}
+
+	VIVIUM_ASSERT(reg.groups.empty(), "Partial views took {} group slots", reg.groups.size());
+	VIVIUM_ASSERT(reg.componentGroups[TypeGenerator::getIdentifier<int>()] == 0, "Partial views took a group bit");
+
+	// int is in every group, owned by two nested groups and partial in two others
+	View<Owned<int>, Owned<float>> outer = reg.createView<Owned<int>, Owned<float>>();
+	View<Owned<int>, Owned<float>, Owned<double>> inner = reg.createView<Owned<int>, Owned<float>, Owned<double>>();
+	View<Owned<char>, Partial<int>> charGroup = reg.createView<Owned<char>, Partial<int>>();
+	View<Owned<short>, Partial<int>, Partial<float>> shortGroup = reg.createView<Owned<short>, Partial<int>, Partial<float>>();
+
+	VIVIUM_ASSERT(reg.groups.size() == 4, "Expected 4 groups, had {}", reg.groups.size());
+	VIVIUM_ASSERT(std::popcount(reg.componentGroups[TypeGenerator::getIdentifier<int>()]) == 4, "int wasn't in every group");
+
+	auto checkAll = [&](char const* name) {
+		_checkGroupPacked(reg, outer.groupMetadata, name);
+		_checkGroupPacked(reg, inner.groupMetadata, name);
+		_checkGroupPacked(reg, charGroup.groupMetadata, name);
+		_checkGroupPacked(reg, shortGroup.groupMetadata, name);
+	};
+
+	constexpr uint64_t dummyCount = 1200;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+		if (i % 3 == 0) reg.addComponent<double>(entities[i], static_cast<double>(i));
+		if (i % 5 == 0) reg.addComponent<char>(entities[i], 'a');
+		if (i % 7 == 0) reg.addComponent<short>(entities[i], static_cast<short>(i));
+	}
+
+	checkAll("before int");
+
+	// Adding and removing the shared component moves entities in and out of all four groups at once
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], static_cast<int>(i));
+	}
+
+	checkAll("added int");
+
+	VIVIUM_ASSERT(charGroup.raw<char>().size() == dummyCount / 5, "Char group had {} entities", charGroup.raw<char>().size());
+	VIVIUM_ASSERT(inner.raw<int>().size() == dummyCount / 6, "Inner group had {} entities", inner.raw<int>().size());
+
+	for (uint64_t i = 0; i < dummyCount; i += 4) {
+		reg.removeComponent<int>(entities[i]);
+	}
+
+	checkAll("removed int");
+
+	std::vector<Entity> removed;
+
+	for (uint64_t i = 1; i < dummyCount; i += 4) {
+		removed.push_back(entities[i]);
+	}
+
+	reg.removeComponents<int>(removed);
+	checkAll("batch removed int");
+
+	uint64_t partialCount = 0;
+
+	for (ViewElement<Partial<int>, Partial<float>>& element : partialViews.back()) {
+		VIVIUM_ASSERT(element.get<int>() % 2 == 0, "Invalid entity in partial view: {}", element.get<int>());
+
+		++partialCount;
+	}
+
+	VIVIUM_ASSERT(partialCount == dummyCount / 4, "Partial view had {} elements", partialCount);
+
+	// Destroying a group shifts the bits of the later groups down
+	reg.destroyView(charGroup);
+
+	for (uint64_t i = 0; i < dummyCount; i += 4) {
+		reg.addComponent<int>(entities[i], static_cast<int>(i));
+	}
+
+	_checkGroupPacked(reg, outer.groupMetadata, "destroyed char group");
+	_checkGroupPacked(reg, inner.groupMetadata, "destroyed char group");
+	_checkGroupPacked(reg, shortGroup.groupMetadata, "destroyed char group");
+
+	for (View<Partial<int>, Partial<float>>& view : partialViews) {
+		reg.destroyView(view);
+	}
+
+	VIVIUM_ASSERT(reg.groups.size() == 3, "Destroying partial views changed the groups");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Shared component test successful");
+}
+
+struct ArchetypeTag {};
+
+void archetypeTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing archetype test");
+
+	ArchetypeRegistry reg;
+
+	// Enough entities to fill several chunks of every archetype
+	constexpr uint64_t dummyCount = 5000;
+	std::vector<Entity> entities(dummyCount);
+
+	reg.createMany(dummyCount, entities);
+
+	for (uint64_t i = 0; i < dummyCount; i++) {
+		reg.addComponent<int>(entities[i], static_cast<int>(i));
+
+		if (i % 2 == 0) reg.addComponent<float>(entities[i], static_cast<float>(i));
+		if (i % 3 == 0) reg.addComponent<ArchetypeTag>(entities[i], ArchetypeTag{});
+	}
+
+	// Every entity of the view is visited once, with its own components
+	auto checkView = [&reg, &entities](char const* name, auto included) {
+		ArchetypeView<Owned<int>, Owned<float>> view = reg.createView<Owned<int>, Owned<float>>();
+		std::vector<bool> visited(dummyCount, false);
+
+		view.each([&](std::span<int> ints, std::span<float> floats, std::span<const Entity> viewEntities) {
+			VIVIUM_ASSERT(ints.size() == floats.size() && ints.size() == viewEntities.size(), "{}: spans had different sizes", name);
+
+			for (uint64_t i = 0; i < ints.size(); i++) {
+				int value = ints[i];
+
+				VIVIUM_ASSERT(included(value), "{}: invalid entity in view: {}", name, value);
+				VIVIUM_ASSERT(!visited[value], "{}: entity {} visited twice", name, value);
+				VIVIUM_ASSERT(viewEntities[i] == entities[value], "{}: entity didn't match element {}", name, value);
+				VIVIUM_ASSERT(floats[i] == static_cast<float>(value), "{}: float part not equal for {}", name, value);
+
+				visited[value] = true;
+			}
+		});
+
+		for (uint64_t i = 0; i < dummyCount; i++) {
+			if (!reg.valid(entities[i])) continue;
+
+			VIVIUM_ASSERT(visited[i] == included(static_cast<int>(i)), "{}: entity {} wasn't visited", name, i);
+			VIVIUM_ASSERT(reg.getComponent<int>(entities[i]) == static_cast<int>(i), "{}: entity {} lost its int", name, i);
+		}
+	};
+
+	Archetype* intFloat = reg.locations.get(getIdentifier(entities[2])).archetype;
+
+	VIVIUM_ASSERT(intFloat->chunks.size() > 1, "Archetype didn't span several chunks");
+
+	checkView("added", [](int value) { return value % 2 == 0; });
+
+	// Moves entities out of the middle of chunks, relocating the last rows into them, until the
+	//	archetype fits in one chunk again
+	for (uint64_t i = 0; i < dummyCount; i += 4) {
+		reg.removeComponent<float>(entities[i]);
+	}
+
+	checkView("removed", [](int value) { return value % 4 == 2; });
+
+	VIVIUM_ASSERT(intFloat->chunks.size() == 1, "Emptied chunks weren't released");
+
+	for (uint64_t i = 0; i < dummyCount; i += 5) {
+		reg.free(entities[i]);
+	}
+
+	checkView("freed", [](int value) { return value % 4 == 2 && value % 5 != 0; });
+
+	// Tags get no span
+	uint64_t taggedCount = 0;
+
+	reg.createView<Owned<int>, Owned<ArchetypeTag>>().each([&taggedCount](std::span<int> ints, std::span<const Entity>) {
+		for (int value : ints) {
+			VIVIUM_ASSERT(value % 3 == 0 && value % 5 != 0, "Invalid entity in tag view: {}", value);
+		}
+
+		taggedCount += ints.size();
+	});
+
+	VIVIUM_ASSERT(taggedCount == 1333, "Tag view had {} elements", taggedCount);
+
+	// Going through a stale handle is fatal, counted here instead of terminating, and mustn't reach the
+	//	entity that recycled its identifier (the last one freed)
+	Entity stale = entities[4995];
+	Entity recycled = reg.create();
+
+	VIVIUM_ASSERT(getIdentifier(stale) == getIdentifier(recycled), "Identifier wasn't recycled");
+
+	reg.addComponent<int>(recycled, -1);
+
+	static uint64_t fatalCount = 0;
+
+	setLogCallback([](LogContext const& context) {
+		if (context.severity == LogSeverity::FATAL) ++fatalCount;
+	});
+
+	reg.addComponent<float>(stale, 1.0f);
+	reg.removeComponent<int>(stale);
+
+	setLogCallback(_defaultLogCallback);
+
+#ifndef NDEBUG
+	VIVIUM_ASSERT(fatalCount == 2, "{} stale accesses reported", fatalCount);
+#endif
+	VIVIUM_ASSERT(reg.getComponent<int>(recycled) == -1, "Stale handle changed the recycled entity");
+	VIVIUM_ASSERT(reg.locations.get(getIdentifier(recycled)).archetype->signature == Signature::of(TypeGenerator::getIdentifier<int>()),
+		"Stale handle moved the recycled entity");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Archetype test successful");
+}
+
+void signatureTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing signature test");
+
+	std::mt19937_64 generator(0x5EED);
+
+	for (uint64_t i = 0; i < 100000; i++) {
+		Signature ours;
+		Signature subset;
+
+		for (uint64_t word = 0; word < ECS_SIGNATURE_WORDS; word++) {
+			ours.words[word] = generator();
+			subset.words[word] = ours.words[word] & generator();
+		}
+
+		// Half the subsets gain a bit the signature lacks, cycling through the words so every
+		//	word (bits 0-63, 64-127, 128-191, 192-255) decides the result
+		if (i % 2 == 1) {
+			uint64_t word = (i / 2) % ECS_SIGNATURE_WORDS;
+			uint64_t bit = word * 64 + generator() % 64;
+
+			ours.reset(bit);
+			subset.set(bit);
+		}
+
+		bool expected = true;
+
+		for (uint64_t bit = 0; bit < ECS_SIGNATURE_BITS; bit++) {
+			if (subset.test(bit) && !ours.test(bit)) expected = false;
+		}
+
+		VIVIUM_ASSERT(expected == (i % 2 == 0), "Subset {} was generated wrong", i);
+		VIVIUM_ASSERT(ours.includes(subset) == expected, "includes() was wrong for subset {}", i);
+		VIVIUM_ASSERT(ours._includesScalar(subset) == expected, "Scalar includes() was wrong for subset {}", i);
+#ifdef VIVIUM_SIGNATURE_SSE2
+		VIVIUM_ASSERT(ours._includesSSE2(subset) == expected, "SSE2 includes() was wrong for subset {}", i);
+#endif
+#ifdef VIVIUM_SIGNATURE_AVX2
+		VIVIUM_ASSERT(ours._includesAVX2(subset) == expected, "AVX2 includes() was wrong for subset {}", i);
+#endif
+	}
+
+	// Constant evaluation takes the scalar path
+	static_assert(Signature::of(3, 70, 140, 200).includes(Signature::of(70, 200)));
+	static_assert(!Signature::of(3, 70, 140).includes(Signature::of(70, 200)));
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Signature test successful");
+}
+
+void pagedArrayTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing paged array test");
+
+	// Page size no other array uses, so the pool is only shared by the arrays here
+	constexpr uint64_t pageSize = 100;
+	using TestArray = PagedArray<uint64_t, pageSize>;
+	PagePool<TestArray::pageBytes>& pool = PagePool<TestArray::pageBytes>::instance();
+
+	TestArray first(7);
+	TestArray second(7);
+
+	VIVIUM_ASSERT(first.defaultPage == second.defaultPage, "Arrays with the same default didn't share a page");
+
+	// Writes through set() and index() never reach the shared default page
+	for (uint64_t i = 0; i < pageSize * 4; i += 3) {
+		first.set(i, i);
+		first.index(i) += 1;
+	}
+
+	for (uint64_t i = 0; i < pageSize; i++) {
+		VIVIUM_ASSERT(first.defaultPage[i] == 7, "Default page was written at {}", i);
+		VIVIUM_ASSERT(second.get(i) == 7, "Write showed through another array at {}", i);
+	}
+
+	first.clear();
+
+	// Released pages are reused rather than taking new blocks
+	constexpr uint64_t pageCount = PagePool<TestArray::pageBytes>::blockPages * 4;
+	uint64_t baseBlocks = pool.blocks.size();
+
+	for (uint64_t repeat = 0; repeat < 3; repeat++) {
+		for (uint64_t i = 0; i < pageCount; i++) {
+			first.set(i * pageSize, 1);
+		}
+
+		VIVIUM_ASSERT(first.allocatedPages == pageCount, "Array had {} pages", first.allocatedPages);
+		VIVIUM_ASSERT(pool.blocks.size() <= baseBlocks + 5, "Pool grew to {} blocks", pool.blocks.size());
+
+		for (uint64_t i = 0; i < pageCount; i++) {
+			first.reset(i * pageSize);
+		}
+
+		VIVIUM_ASSERT(first.allocatedPages == 0, "Pages weren't released");
+
+		// Emptied blocks go back to the system, apart from the spare block
+		VIVIUM_ASSERT(pool.blocks.size() <= baseBlocks + 1, "Pool kept {} blocks", pool.blocks.size());
+	}
+
+	// A page released by one array is taken by the next write of another
+	first.set(0, 1);
+	uint64_t* released = first.pages[0];
+	first.reset(0);
+	second.set(0, 1);
+
+	VIVIUM_ASSERT(second.pages[0] == released, "Released page wasn't reused");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Paged array test successful");
 }
\ No newline at end of file
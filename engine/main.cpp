@@ -1,5 +1,6 @@
 #include "state.h"
 #include "ecstest.h"
+#include "physicstest.h"
 
 void game() {
 	State state;
@@ -11,6 +12,32 @@ void game() {
 
 void ecs() {
 	groupTest();
+	parallelViewTest();
+	commandBufferTest();
+	changeDetectionTest();
+	partialViewTest();
+	entityVersionTest();
+	sortTest();
+	snapshotTest();
+	tagTest();
+	nestedGroupTest();
+	signalTest();
+	emplaceTest();
+	commandOrderTest();
+	duplicateAddTest();
+	sharedComponentTest();
+	archetypeTest();
+	signatureTest();
+	pagedArrayTest();
+}
+
+void physics() {
+	broadphaseTest();
+	worldTest();
+	narrowphaseTest();
+	stackingTest();
+	substepTest();
+	sleepingTest();
 }
 
 int main(void) {
@@ -0,0 +1,309 @@
+// Standalone physics benchmark suite, built as the physics_bench target
+// Usage: physics_bench [--json path] [--filter substring] [--repetitions n] [--entities n,n,...]
+// Build in release
+
+#include "benchmark.h"
+
+#include "../vivium4/physics/broadphase.h"
+#include "../vivium4/physics/physics.h"
+#include "../vivium4/physics/world.h"
+
+#include <cmath>
+
+using namespace Vivium;
+
+// Unit-ish boxes spread at constant density, so the number of overlaps grows linearly with the body count
+struct BroadphaseScene {
+	std::vector<AABB> bounds;
+	std::vector<F32x2> velocities;
+
+	BroadphaseScene(uint64_t bodyCount, uint64_t seed) : bounds(bodyCount), velocities(bodyCount) {
+		std::mt19937_64 generator(seed);
+
+		float side = std::sqrt(static_cast<float>(bodyCount)) * 2.0f;
+
+		auto uniform = [&generator](float min, float max) {
+			return min + (max - min) * static_cast<float>(generator() >> 40) / static_cast<float>(1 << 24);
+		};
+
+		for (uint64_t i = 0; i < bodyCount; i++) {
+			F32x2 position(uniform(0.0f, side), uniform(0.0f, side));
+			F32x2 size(uniform(0.5f, 1.5f), uniform(0.5f, 1.5f));
+
+			bounds[i] = AABB{ position, position + size };
+			velocities[i] = F32x2(uniform(-0.02f, 0.02f), uniform(-0.02f, 0.02f));
+		}
+	}
+
+	void step() {
+		for (uint64_t i = 0; i < bounds.size(); i++) {
+			bounds[i].min += velocities[i];
+			bounds[i].max += velocities[i];
+		}
+	}
+};
+
+inline constexpr uint64_t broadphaseSteps = 10;
+
+// Times update and findPairs over a number of steps, after a first untimed update builds the structure
+template <typename BroadphaseType, typename... Args>
+void _broadphaseCase(BenchmarkSuite& suite, std::string const& name, Args... args) {
+	suite.add(name, [args...](BenchmarkRun& run) {
+		BroadphaseScene scene(run.entityCount, run.seed);
+		BroadphaseType broadphase(args...);
+
+		broadphase.update(scene.bounds);
+
+		run.measure(run.entityCount * broadphaseSteps, [&scene, &broadphase] {
+			uint64_t pairCount = 0;
+
+			for (uint64_t step = 0; step < broadphaseSteps; step++) {
+				scene.step();
+
+				broadphase.update(scene.bounds);
+				pairCount += broadphase.findPairs().size();
+			}
+
+			benchmarkKeep(pairCount);
+		});
+	});
+}
+
+void _broadphaseCases(BenchmarkSuite& suite) {
+	// What Physics::solve used to do
+	suite.add("pairs_brute_force", [](BenchmarkRun& run) {
+		BroadphaseScene scene(run.entityCount, run.seed);
+		std::vector<Physics::BodyPair> pairs;
+
+		run.measure(run.entityCount * broadphaseSteps, [&scene, &pairs] {
+			uint64_t pairCount = 0;
+
+			for (uint64_t step = 0; step < broadphaseSteps; step++) {
+				scene.step();
+				pairs.clear();
+
+				for (uint32_t i = 0; i < scene.bounds.size(); i++) {
+					for (uint32_t j = i + 1; j < scene.bounds.size(); j++) {
+						if (scene.bounds[i].intersects(scene.bounds[j])) pairs.push_back(Physics::BodyPair{ i, j });
+					}
+				}
+
+				pairCount += pairs.size();
+			}
+
+			benchmarkKeep(pairCount);
+		});
+	});
+
+	_broadphaseCase<Physics::TreeBroadphase>(suite, "pairs_tree", 0.1f);
+	_broadphaseCase<Physics::SweepAndPrune>(suite, "pairs_sweep_and_prune");
+	_broadphaseCase<Physics::UniformGrid>(suite, "pairs_grid", 2.0f);
+}
+
+// Dynamic bodies with a force applied, one in eight static, in creation order
+std::vector<Physics::Body> _integrationBodies(uint64_t bodyCount) {
+	static Polygon box = createPolygonBox(F32x2(1.0f));
+
+	std::vector<Physics::Body> bodies(bodyCount);
+
+	for (uint64_t i = 0; i < bodyCount; i++) {
+		bool isStatic = i % 8 == 0;
+
+		bodies[i] = Physics::Body{
+			F32x2(static_cast<float>(i), 0.0f), F32x2(1.0f, 0.0f), F32x2(0.0f, -9.8f),
+			0.0f, 0.5f, 0.1f,
+			isStatic ? 0.0f : 0.5f, isStatic ? 0.0f : 1.0f,
+			Physics::Shape(&box), Physics::Material::Default, true
+		};
+	}
+
+	return bodies;
+}
+
+inline constexpr uint64_t integrationSteps = 10;
+
+void _integrationCases(BenchmarkSuite& suite) {
+	std::vector<uint64_t> bodyCounts = { 10000, 100000 };
+
+	suite.add("integrate_per_body", [](BenchmarkRun& run) {
+		std::vector<Physics::Body> bodies = _integrationBodies(run.entityCount);
+
+		run.measure(run.entityCount * integrationSteps, [&bodies] {
+			for (uint64_t step = 0; step < integrationSteps; step++) {
+				for (Physics::Body& body : bodies) {
+					Physics::update(body, 1.0f / 60.0f);
+				}
+			}
+
+			benchmarkKeep(bodies.back().position.x);
+		});
+	}, bodyCounts);
+
+	suite.add("integrate_world", [](BenchmarkRun& run) {
+		Physics::PhysicsWorld world;
+
+		for (Physics::Body const& body : _integrationBodies(run.entityCount)) {
+			world.add(body);
+		}
+
+		run.measure(run.entityCount * integrationSteps, [&world] {
+			for (uint64_t step = 0; step < integrationSteps; step++) {
+				world.integrate(1.0f / 60.0f);
+			}
+
+			benchmarkKeep(world.positionX.front());
+		});
+	}, bodyCounts);
+}
+
+// Boxes on a grid slightly closer than their size, at random angles, so each touches several neighbours
+std::vector<Physics::Body> _pileBodies(uint64_t bodyCount, uint64_t seed) {
+	static Polygon box = createPolygonBox(F32x2(1.0f));
+
+	std::mt19937_64 generator(seed);
+	uint64_t columns = static_cast<uint64_t>(std::sqrt(static_cast<float>(bodyCount)));
+
+	std::vector<Physics::Body> bodies(bodyCount);
+
+	for (uint64_t i = 0; i < bodyCount; i++) {
+		float angle = static_cast<float>(generator() >> 40) / static_cast<float>(1 << 24) * 0.3f;
+
+		bodies[i] = Physics::Body{
+			F32x2(static_cast<float>(i % columns), static_cast<float>(i / columns)) * 0.95f, F32x2(0.0f), F32x2(0.0f),
+			angle, 0.0f, 0.0f,
+			1.0f / inertiaPolygon(box), 1.0f,
+			Physics::Shape(&box), Physics::Material::Default, true
+		};
+	}
+
+	return bodies;
+}
+
+// One collision pass, after the broadphase is built, so the cost is mostly the narrow phase
+void _collisionCases(BenchmarkSuite& suite) {
+	// Transforms built for every pair, by checkCollisionAndResolve
+	suite.add("collide_bodies", [](BenchmarkRun& run) {
+		std::vector<Physics::Body> bodies = _pileBodies(run.entityCount, run.seed);
+		std::vector<Physics::Body*> pointers(bodies.size());
+
+		std::vector<AABB> bounds(bodies.size());
+
+		for (uint64_t i = 0; i < bodies.size(); i++) {
+			pointers[i] = &bodies[i];
+			bounds[i] = Physics::bodyBounds(bodies[i]);
+		}
+
+		Physics::TreeBroadphase broadphase;
+		broadphase.update(bounds);
+
+		run.measure(run.entityCount, [&pointers, &broadphase] {
+			Physics::solve(std::span<Physics::Body*>(pointers), broadphase);
+
+			benchmarkKeep(pointers.front()->velocity.x);
+		});
+	});
+
+	// Transforms cached once per body, a single solver iteration to match resolving each pair once
+	suite.add("collide_world", [](BenchmarkRun& run) {
+		Physics::PhysicsWorld world;
+		world.velocityIterations = 1;
+
+		for (Physics::Body const& body : _pileBodies(run.entityCount, run.seed)) {
+			world.add(body);
+		}
+
+		// Builds the broadphase and its pairs
+		world.collide();
+
+		run.measure(run.entityCount, [&world] {
+			world.collide();
+			world.solveContacts(1.0f / 60.0f);
+
+			benchmarkKeep(world.velocityX.front());
+		});
+	});
+
+	// Whole steps with the default solver iterations, warm started from the step before
+	suite.add("step_world", [](BenchmarkRun& run) {
+		Physics::PhysicsWorld world;
+
+		for (Physics::Body const& body : _pileBodies(run.entityCount, run.seed)) {
+			world.add(body);
+		}
+
+		world.step(1.0f / 60.0f);
+
+		run.measure(run.entityCount, [&world] {
+			world.step(1.0f / 60.0f);
+
+			benchmarkKeep(world.positionX.front());
+		});
+	});
+}
+
+inline constexpr uint64_t columnHeight = 5;
+inline constexpr uint64_t restingSteps = 10;
+
+// Columns of crates on a wide ground, stepped until they settle, then every fifth column woken, so most
+//	bodies are at rest as in a level
+void _restingCase(BenchmarkRun& run, bool allowSleeping) {
+	static Polygon crate = createPolygonBox(F32x2(1.0f));
+
+	uint64_t columns = (run.entityCount + columnHeight - 1) / columnHeight;
+	Polygon ground = createPolygonBox(F32x2(static_cast<float>(columns) * 2.0f + 2.0f, 1.0f));
+
+	Physics::PhysicsWorld world;
+	world.allowSleeping = allowSleeping;
+
+	world.add(Physics::Body{ F32x2(static_cast<float>(columns), 0.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		Physics::Shape(&ground), Physics::Material::Default, true });
+
+	std::vector<Physics::BodyHandle> crates(run.entityCount);
+
+	for (uint64_t i = 0; i < run.entityCount; i++) {
+		F32x2 position(static_cast<float>(i / columnHeight) * 2.0f + 1.0f, static_cast<float>(i % columnHeight) + 1.0f);
+
+		crates[i] = world.add(Physics::Body{ position, F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f,
+			1.0f / inertiaPolygon(crate), 1.0f, Physics::Shape(&crate), Physics::Material::Default, true });
+	}
+
+	auto stepWithGravity = [&world, &crates] {
+		for (Physics::BodyHandle handle : crates) world.addForce(handle, F32x2(0.0f, -9.8f));
+
+		world.step(1.0f / 60.0f);
+	};
+
+	for (uint64_t step = 0; step < 120; step++) stepWithGravity();
+
+	for (uint64_t i = 0; i < run.entityCount; i += columnHeight * 5) world.wake(crates[i]);
+
+	run.measure(run.entityCount * restingSteps, [&stepWithGravity, &world] {
+		for (uint64_t step = 0; step < restingSteps; step++) stepWithGravity();
+
+		benchmarkKeep(world.positionY.front());
+	});
+}
+
+void _sleepingCases(BenchmarkSuite& suite) {
+	std::vector<uint64_t> bodyCounts = { 1000, 3000 };
+
+	suite.add("step_resting_awake", [](BenchmarkRun& run) { _restingCase(run, false); }, bodyCounts);
+	suite.add("step_resting_sleeping", [](BenchmarkRun& run) { _restingCase(run, true); }, bodyCounts);
+}
+
+int main(int argc, char** argv) {
+	_logInit();
+
+	BenchmarkSuite suite;
+	suite.name = "physics";
+	suite.entityCounts = { 1000, 3000, 10000 };
+
+	if (!suite.parseArguments(argc, argv)) return 1;
+
+	_broadphaseCases(suite);
+	_integrationCases(suite);
+	_collisionCases(suite);
+	_sleepingCases(suite);
+
+	return suite.runMain();
+}
\ No newline at end of file
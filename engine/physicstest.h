@@ -0,0 +1,506 @@
+#include "../vivium4/vivium4.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Vivium;
+
+// Pairs whose bounds actually intersect, sorted, each pair once
+std::vector<std::pair<uint32_t, uint32_t>> _overlappingPairs(std::span<const Physics::BodyPair> pairs, std::span<const AABB> bounds) {
+	std::vector<std::pair<uint32_t, uint32_t>> overlapping;
+
+	for (Physics::BodyPair pair : pairs) {
+		VIVIUM_ASSERT(pair.a < pair.b, "Pair ({}, {}) out of order", pair.a, pair.b);
+
+		if (bounds[pair.a].intersects(bounds[pair.b])) overlapping.push_back({ pair.a, pair.b });
+	}
+
+	std::sort(overlapping.begin(), overlapping.end());
+
+	return overlapping;
+}
+
+void broadphaseTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing broadphase test");
+
+	VIVIUM_ASSERT(!AABBIntersectAABB(F32x2(0.0f), F32x2(1.0f), F32x2(2.0f, 0.0f), F32x2(3.0f, 1.0f)), "Boxes apart on x intersected");
+	VIVIUM_ASSERT(!AABBIntersectAABB(F32x2(0.0f), F32x2(1.0f), F32x2(0.0f, -3.0f), F32x2(1.0f, -2.0f)), "Boxes apart on y intersected");
+	VIVIUM_ASSERT(AABBIntersectAABB(F32x2(0.0f), F32x2(1.0f), F32x2(0.5f), F32x2(2.0f)), "Overlapping boxes didn't intersect");
+
+	constexpr uint64_t bodyCount = 600;
+	constexpr uint64_t stepCount = 20;
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> positionDistribution(0.0f, 40.0f);
+	std::uniform_real_distribution<float> sizeDistribution(0.2f, 2.0f);
+	std::uniform_real_distribution<float> velocityDistribution(-0.3f, 0.3f);
+
+	std::vector<AABB> bounds(bodyCount);
+	std::vector<F32x2> velocities(bodyCount);
+
+	for (uint64_t i = 0; i < bodyCount; i++) {
+		F32x2 position(positionDistribution(generator), positionDistribution(generator));
+		F32x2 size(sizeDistribution(generator), sizeDistribution(generator));
+
+		bounds[i] = AABB{ position, position + size };
+		velocities[i] = F32x2(velocityDistribution(generator), velocityDistribution(generator));
+	}
+
+	Physics::TreeBroadphase tree(0.5f);
+	Physics::SweepAndPrune sweep;
+	Physics::UniformGrid grid(2.0f);
+
+	for (uint64_t step = 0; step < stepCount; step++) {
+		// Drop bodies off the end halfway through, which removes their tree proxies
+		uint64_t count = step < stepCount / 2 ? bodyCount : bodyCount - 100;
+		std::span<const AABB> stepBounds(bounds.data(), count);
+
+		std::vector<Physics::BodyPair> bruteForce;
+
+		for (uint32_t i = 0; i < count; i++) {
+			for (uint32_t j = i + 1; j < count; j++) {
+				if (bounds[i].intersects(bounds[j])) bruteForce.push_back(Physics::BodyPair{ i, j });
+			}
+		}
+
+		std::vector<std::pair<uint32_t, uint32_t>> expected = _overlappingPairs(bruteForce, stepBounds);
+
+		tree.update(stepBounds);
+		sweep.update(stepBounds);
+		grid.update(stepBounds);
+
+		// Tree pairs are of fattened bounds, so can include pairs that don't overlap
+		VIVIUM_ASSERT(_overlappingPairs(tree.findPairs(), stepBounds) == expected, "Tree pairs differed at step {}", step);
+
+		std::span<const Physics::BodyPair> sweepPairs = sweep.findPairs();
+		std::span<const Physics::BodyPair> gridPairs = grid.findPairs();
+
+		VIVIUM_ASSERT(sweepPairs.size() == expected.size() && _overlappingPairs(sweepPairs, stepBounds) == expected, "Sweep and prune pairs differed at step {}", step);
+		VIVIUM_ASSERT(gridPairs.size() == expected.size() && _overlappingPairs(gridPairs, stepBounds) == expected, "Grid pairs differed at step {}", step);
+
+		for (uint64_t i = 0; i < bodyCount; i++) {
+			bounds[i].min += velocities[i];
+			bounds[i].max += velocities[i];
+		}
+	}
+
+	// Nothing moved since the last update, so the tree keeps every proxy where it is
+	std::span<const AABB> finalBounds(bounds.data(), bodyCount - 100);
+
+	tree.update(finalBounds);
+	VIVIUM_ASSERT(!tree.update(finalBounds), "Tree reinserted unmoved proxies");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Broadphase test successful");
+}
+
+void worldTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing physics world test");
+
+	static Polygon box = createPolygonBox(F32x2(1.0f));
+
+	Physics::PhysicsWorld world;
+
+	// Bodies far enough apart to never collide, a count that leaves a tail after the vector lanes
+	constexpr uint64_t bodyCount = 43;
+	constexpr uint64_t stepCount = 30;
+	constexpr float deltaTime = 1.0f / 60.0f;
+
+	std::vector<Physics::Body> reference(bodyCount);
+	std::vector<Physics::BodyHandle> handles(bodyCount);
+
+	for (uint64_t i = 0; i < bodyCount; i++) {
+		Physics::Body& body = reference[i];
+
+		body.position = F32x2(static_cast<float>(i) * 10.0f, 0.0f);
+		body.velocity = F32x2(static_cast<float>(i % 3), 1.0f);
+		body.force = F32x2(0.0f);
+		body.angle = 0.0f;
+		body.angularVelocity = 0.1f * static_cast<float>(i % 5);
+		body.torque = 0.0f;
+		// Every seventh body is static
+		body.inverseMass = i % 7 == 0 ? 0.0f : 1.0f / static_cast<float>(1 + i % 4);
+		body.inverseInertia = i % 7 == 0 ? 0.0f : 0.5f;
+		body.shape = Physics::Shape(&box);
+		body.material = Physics::Material::Default;
+		body.enabled = true;
+
+		handles[i] = world.add(body);
+	}
+
+	VIVIUM_ASSERT(world.dynamicCount == bodyCount - (bodyCount + 6) / 7, "World had {} dynamic bodies", world.dynamicCount);
+
+	auto checkMatches = [&world, &reference, &handles](uint64_t i) {
+		F32x2 position = world.getPosition(handles[i]);
+		F32x2 expected = reference[i].position;
+
+		VIVIUM_ASSERT(F32x2::length(position - expected) < 1e-3f, "Body {} at ({}, {}) expected ({}, {})", i, position.x, position.y, expected.x, expected.y);
+		VIVIUM_ASSERT(std::abs(world.getAngle(handles[i]) - reference[i].angle) < 1e-3f, "Body {} angle differed", i);
+	};
+
+	for (uint64_t step = 0; step < stepCount; step++) {
+		for (uint64_t i = 0; i < bodyCount; i++) {
+			F32x2 force(static_cast<float>(step % 4), -9.8f);
+
+			world.addForce(handles[i], force);
+			world.addTorque(handles[i], 0.25f);
+
+			reference[i].force += force;
+			reference[i].torque += 0.25f;
+
+			Physics::update(reference[i], deltaTime);
+
+			// Forces on static bodies are never applied, update just leaves them accumulating
+			if (reference[i].inverseMass == 0.0f) {
+				reference[i].force = F32x2(0.0f);
+				reference[i].torque = 0.0f;
+			}
+		}
+
+		world.step(deltaTime);
+	}
+
+	for (uint64_t i = 0; i < bodyCount; i++) checkMatches(i);
+
+	// Remaining handles stay valid as bodies are removed and partitions shuffle
+	for (uint64_t i = 0; i < bodyCount; i += 3) {
+		world.remove(handles[i]);
+
+		VIVIUM_ASSERT(!world.valid(handles[i]), "Removed body {} still valid", i);
+	}
+
+	for (uint64_t i = 0; i < bodyCount; i++) {
+		if (i % 3 != 0) checkMatches(i);
+	}
+
+	// Making a body static moves it out of the integrated range
+	Physics::Body frozen = world.get(handles[1]);
+	frozen.inverseMass = 0.0f;
+	frozen.inverseInertia = 0.0f;
+	world.set(handles[1], frozen);
+
+	F32x2 frozenPosition = world.getPosition(handles[1]);
+	world.step(deltaTime);
+
+	VIVIUM_ASSERT(world.getPosition(handles[1]) == frozenPosition, "Static body moved");
+	VIVIUM_ASSERT(world.get(handles[2]).inverseMass != 0.0f && world.getPosition(handles[2]) != reference[2].position, "Dynamic body didn't move");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Physics world test successful");
+}
+
+
+void narrowphaseTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing narrow phase test");
+
+	std::array<Polygon, 3> polygons = {
+		createPolygonBox(F32x2(1.0f)),
+		createPolygonBox(F32x2(2.0f, 0.5f)),
+		createPolygonRegular(0.8f, 5)
+	};
+
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> offsetDistribution(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> angleDistribution(-3.14f, 3.14f);
+
+	uint64_t collidingCount = 0;
+
+	// World space polygons give the same manifold as transforming on the fly
+	for (uint64_t i = 0; i < 500; i++) {
+		Polygon const& a = polygons[i % 3];
+		Polygon const& b = polygons[(i / 3) % 3];
+
+		Transform transformA{ F32x2(0.0f), Mat2x2::fromAngle(angleDistribution(generator)), Mat2x2::identity() };
+		Transform transformB{ F32x2(offsetDistribution(generator), offsetDistribution(generator)), Mat2x2::fromAngle(angleDistribution(generator)), Mat2x2::identity() };
+		transformA.rotationInverse = transformA.rotation.transpose();
+		transformB.rotationInverse = transformB.rotation.transpose();
+
+		std::vector<F32x2> vertices[2], normals[2];
+
+		for (uint64_t j = 0; j < 2; j++) {
+			Polygon const& polygon = j == 0 ? a : b;
+			Transform const& transform = j == 0 ? transformA : transformB;
+
+			for (uint64_t k = 0; k < polygon.vertices.size(); k++) {
+				vertices[j].push_back(applyTransform(polygon.vertices[k], transform));
+				normals[j].push_back(transform.rotation * polygon.normals[k]);
+			}
+		}
+
+		Physics::PenetrationManifold expected = Physics::polygonToPolygon(a, b, transformA, transformB);
+		Physics::PenetrationManifold manifold = Physics::polygonToPolygon(
+			Physics::WorldPolygon{ vertices[0], normals[0] },
+			Physics::WorldPolygon{ vertices[1], normals[1] }
+		);
+
+		VIVIUM_ASSERT(manifold.contactCount == expected.contactCount, "Pair {} had {} contacts, expected {}", i, manifold.contactCount, expected.contactCount);
+
+		if (expected.contactCount == 0) continue;
+
+		++collidingCount;
+
+		VIVIUM_ASSERT(std::abs(manifold.depth - expected.depth) < 1e-3f, "Pair {} depth {} expected {}", i, manifold.depth, expected.depth);
+		VIVIUM_ASSERT(F32x2::length(manifold.vector - expected.vector) < 1e-3f, "Pair {} normal differed", i);
+
+		for (uint64_t j = 0; j < expected.contactCount; j++) {
+			VIVIUM_ASSERT(F32x2::length(manifold.contacts[j] - expected.contacts[j]) < 1e-3f, "Pair {} contact {} differed", i, j);
+		}
+	}
+
+	VIVIUM_ASSERT(collidingCount > 100, "Only {} pairs collided", collidingCount);
+
+	// A box dropped on the ground through the world's cached narrow phase comes to rest on it
+	static Polygon ground = createPolygonBox(F32x2(20.0f, 1.0f));
+	static Polygon crate = createPolygonBox(F32x2(1.0f));
+
+	Physics::PhysicsWorld world;
+
+	world.add(Physics::Body{ F32x2(0.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		Physics::Shape(&ground), Physics::Material::Default, true });
+	Physics::BodyHandle dropped = world.add(Physics::Body{ F32x2(0.0f, 3.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 1.0f / inertiaPolygon(crate), 1.0f,
+		Physics::Shape(&crate), Physics::Material::Default, true });
+
+	for (uint64_t step = 0; step < 240; step++) {
+		world.addForce(dropped, F32x2(0.0f, -9.8f));
+		world.step(1.0f / 60.0f);
+	}
+
+	F32x2 restingPosition = world.getPosition(dropped);
+
+	// Resting on the top of the ground at 0.5, within the correction slop
+	VIVIUM_ASSERT(std::abs(restingPosition.y - 1.0f) < 0.1f, "Box came to rest at {}", restingPosition.y);
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Narrow phase test successful");
+}
+
+void stackingTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing stacking test");
+
+	static Polygon ground = createPolygonBox(F32x2(20.0f, 1.0f));
+	static Polygon crate = createPolygonBox(F32x2(1.0f));
+
+	// A stack only stays up if contact impulses carry over between steps and friction holds
+	Physics::PhysicsWorld world;
+
+	world.add(Physics::Body{ F32x2(0.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		Physics::Shape(&ground), Physics::Material::Default, true });
+
+	constexpr uint64_t stackHeight = 6;
+	std::array<Physics::BodyHandle, stackHeight> crates;
+
+	for (uint64_t i = 0; i < stackHeight; i++) {
+		crates[i] = world.add(Physics::Body{ F32x2(0.0f, 1.0f + static_cast<float>(i)), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f,
+			1.0f / inertiaPolygon(crate), 1.0f, Physics::Shape(&crate), Physics::Material::Default, true });
+	}
+
+	for (uint64_t step = 0; step < 300; step++) {
+		for (Physics::BodyHandle handle : crates) world.addForce(handle, F32x2(0.0f, -9.8f));
+
+		world.step(1.0f / 60.0f);
+	}
+
+	for (uint64_t i = 0; i < stackHeight; i++) {
+		F32x2 position = world.getPosition(crates[i]);
+
+		VIVIUM_ASSERT(std::abs(position.x) < 0.05f && std::abs(position.y - (1.0f + static_cast<float>(i))) < 0.1f,
+			"Crate {} at ({}, {})", i, position.x, position.y);
+		VIVIUM_ASSERT(F32x2::length(world.getVelocity(crates[i])) < 0.1f, "Crate {} still moving", i);
+	}
+
+	// One manifold per resting contact, each holding up the weight of the crates above it
+	VIVIUM_ASSERT(world.manifolds.size() == stackHeight, "{} manifolds for a stack of {}", world.manifolds.size(), stackHeight);
+
+	for (Physics::ContactManifold const& manifold : world.manifolds) {
+		VIVIUM_ASSERT(manifold.contactCount == 2, "Resting manifold had {} contacts", manifold.contactCount);
+
+		uint64_t upper = std::find(crates.begin(), crates.end(), manifold.handleB) - crates.begin();
+		float weight = static_cast<float>(stackHeight - upper) * 9.8f / 60.0f;
+		float normalImpulse = manifold.points[0].normalImpulse + manifold.points[1].normalImpulse;
+
+		VIVIUM_ASSERT(std::abs(normalImpulse - weight) < weight * 0.1f, "Contact under crate {} pushed {}, expected {}", upper, normalImpulse, weight);
+	}
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Stacking test successful");
+}
+
+void substepTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing substep test");
+
+	static Polygon ground = createPolygonBox(F32x2(20.0f, 1.0f));
+	static Polygon crate = createPolygonBox(F32x2(1.0f));
+
+	auto makeWorld = [](Physics::PhysicsWorld& world) {
+		world.add(Physics::Body{ F32x2(0.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+			Physics::Shape(&ground), Physics::Material::Default, true });
+
+		for (uint64_t i = 0; i < 3; i++) {
+			world.add(Physics::Body{ F32x2(static_cast<float>(i) * 0.3f, 1.5f + static_cast<float>(i) * 1.2f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f,
+				1.0f / inertiaPolygon(crate), 1.0f, Physics::Shape(&crate), Physics::Material::Default, true });
+		}
+	};
+
+	Physics::PhysicsWorld advanced, stepped;
+	makeWorld(advanced);
+	makeWorld(stepped);
+
+	// Uneven frames run the same fixed steps as stepping directly, with forces held over each frame's steps
+	constexpr std::array<float, 5> frameTimes = { 0.016f, 0.05f, 0.004f, 0.021f, 0.033f };
+	uint32_t totalSteps = 0;
+
+	for (uint64_t frame = 0; frame < 60; frame++) {
+		for (Physics::BodyHandle handle = 1; handle < 4; handle++) advanced.addForce(handle, F32x2(0.0f, -9.8f));
+
+		uint32_t steps = advanced.advance(frameTimes[frame % frameTimes.size()]);
+
+		for (uint32_t i = 0; i < steps; i++) {
+			for (Physics::BodyHandle handle = 1; handle < 4; handle++) stepped.addForce(handle, F32x2(0.0f, -9.8f));
+
+			stepped.step(stepped.fixedDeltaTime);
+		}
+
+		totalSteps += steps;
+
+		float alpha = advanced.interpolationAlpha();
+		VIVIUM_ASSERT(alpha >= 0.0f && alpha < 1.0f, "Alpha {} outside a step", alpha);
+	}
+
+	float totalTime = 0.0f;
+	for (uint64_t frame = 0; frame < 60; frame++) totalTime += frameTimes[frame % frameTimes.size()];
+
+	VIVIUM_ASSERT(totalSteps == static_cast<uint32_t>(totalTime / advanced.fixedDeltaTime), "Ran {} steps in {}s", totalSteps, totalTime);
+
+	for (Physics::BodyHandle handle = 1; handle < 4; handle++) {
+		VIVIUM_ASSERT(F32x2::length(advanced.getPosition(handle) - stepped.getPosition(handle)) < 1e-4f, "Body {} differed from stepping", handle);
+
+		// Interpolated between the last two steps
+		F32x2 interpolated = advanced.getInterpolatedPosition(handle);
+		F32x2 previous(advanced.previousPositionX[advanced.handleIndices[handle]], advanced.previousPositionY[advanced.handleIndices[handle]]);
+		F32x2 current = advanced.getPosition(handle);
+
+		VIVIUM_ASSERT(F32x2::length(previous + (current - previous) * advanced.interpolationAlpha() - interpolated) < 1e-5f, "Body {} interpolated wrongly", handle);
+	}
+
+	// A long hitch runs at most maxSubsteps, and doesn't carry the rest to the next frame
+	VIVIUM_ASSERT(advanced.advance(1.0f) == advanced.maxSubsteps, "Hitch wasn't capped");
+	VIVIUM_ASSERT(advanced.advance(0.0f) == 0, "Hitch carried over");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Substep test successful");
+}
+
+void sleepingTest() {
+	_logInit();
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Doing sleeping test");
+
+	static Polygon ground = createPolygonBox(F32x2(20.0f, 1.0f));
+	static Polygon crate = createPolygonBox(F32x2(1.0f));
+
+	Physics::PhysicsWorld world;
+
+	Physics::BodyHandle groundHandle = world.add(Physics::Body{ F32x2(0.0f), F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		Physics::Shape(&ground), Physics::Material::Default, true });
+
+	auto addCrate = [&world](F32x2 position) {
+		return world.add(Physics::Body{ position, F32x2(0.0f), F32x2(0.0f), 0.0f, 0.0f, 0.0f,
+			1.0f / inertiaPolygon(crate), 1.0f, Physics::Shape(&crate), Physics::Material::Default, true });
+	};
+
+	std::vector<Physics::BodyHandle> crates;
+
+	for (uint64_t i = 0; i < 3; i++) crates.push_back(addCrate(F32x2(0.0f, 1.0f + static_cast<float>(i))));
+
+	// On the same ground, but not touching the stack, so in its own island
+	Physics::BodyHandle lone = addCrate(F32x2(5.0f, 1.0f));
+
+	auto stepWithGravity = [&world, &crates, lone] {
+		for (Physics::BodyHandle handle : crates) world.addForce(handle, F32x2(0.0f, -9.8f));
+		world.addForce(lone, F32x2(0.0f, -9.8f));
+
+		world.step(1.0f / 60.0f);
+	};
+
+	auto stackAwake = [&world, &crates] {
+		return std::all_of(crates.begin(), crates.begin() + 3, [&world](Physics::BodyHandle handle) { return world.isAwake(handle); });
+	};
+
+	for (uint64_t step = 0; step < 120; step++) stepWithGravity();
+
+	VIVIUM_ASSERT(world.awakeCount == 0, "{} bodies still awake after settling", world.awakeCount);
+
+	// Sleeping bodies aren't integrated, and keep their contacts
+	std::vector<F32x2> restingPositions;
+	for (Physics::BodyHandle handle : crates) restingPositions.push_back(world.getPosition(handle));
+
+	for (uint64_t step = 0; step < 60; step++) stepWithGravity();
+
+	for (uint64_t i = 0; i < crates.size(); i++) {
+		VIVIUM_ASSERT(world.getPosition(crates[i]) == restingPositions[i], "Sleeping crate {} moved", i);
+		VIVIUM_ASSERT(world.getVelocity(crates[i]) == F32x2(0.0f), "Sleeping crate {} kept its velocity", i);
+	}
+
+	VIVIUM_ASSERT(world.manifolds.size() == 4, "Sleeping bodies kept {} manifolds", world.manifolds.size());
+
+	// Landing on the top crate wakes the whole stack through its contacts, but not the lone crate
+	crates.push_back(addCrate(F32x2(0.0f, 6.0f)));
+
+	bool stackWoke = false;
+
+	for (uint64_t step = 0; step < 240; step++) {
+		stepWithGravity();
+
+		if (stackAwake()) {
+			stackWoke = true;
+
+			VIVIUM_ASSERT(!world.isAwake(lone), "Lone crate woke with the stack");
+		}
+	}
+
+	VIVIUM_ASSERT(stackWoke, "Stack never woke");
+	VIVIUM_ASSERT(world.awakeCount == 0, "{} bodies still awake after the stack settled", world.awakeCount);
+	VIVIUM_ASSERT(std::abs(world.getPosition(crates.back()).y - 4.0f) < 0.1f, "Dropped crate came to rest at {}", world.getPosition(crates.back()).y);
+
+	// Waking one body wakes its island on the next step
+	world.wake(crates[1]);
+
+	VIVIUM_ASSERT(world.isAwake(crates[1]) && !world.isAwake(crates[0]), "Wake changed the wrong bodies");
+
+	stepWithGravity();
+
+	VIVIUM_ASSERT(stackAwake() && !world.isAwake(lone), "Wake didn't spread through the island");
+
+	world.allowSleeping = false;
+	stepWithGravity();
+
+	VIVIUM_ASSERT(world.awakeCount == world.dynamicCount, "Disabling sleeping left bodies asleep");
+
+	// Removing the ground from under sleeping bodies wakes them, and they fall
+	world.allowSleeping = true;
+
+	for (uint64_t step = 0; step < 120; step++) stepWithGravity();
+
+	VIVIUM_ASSERT(world.awakeCount == 0, "{} bodies still awake after settling again", world.awakeCount);
+
+	std::vector<float> supportedHeights;
+	for (Physics::BodyHandle handle : crates) supportedHeights.push_back(world.getPosition(handle).y);
+	supportedHeights.push_back(world.getPosition(lone).y);
+
+	world.remove(groundHandle);
+
+	for (uint64_t step = 0; step < 60; step++) stepWithGravity();
+
+	for (uint64_t i = 0; i < crates.size(); i++) {
+		VIVIUM_ASSERT(world.isAwake(crates[i]) && world.getPosition(crates[i]).y < supportedHeights[i] - 1.0f, "Crate {} stayed up without the ground", i);
+	}
+
+	VIVIUM_ASSERT(world.isAwake(lone) && world.getPosition(lone).y < supportedHeights.back() - 1.0f, "Lone crate stayed up without the ground");
+
+	VIVIUM_LOG(LogSeverity::DEBUG, "Sleeping test successful");
+}
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "archetype.h"
+
+#include <new>
+
+namespace Vivium {
+	static uint64_t _alignToCacheLine(uint64_t value) {
+		return (value + ECS_CACHE_LINE_SIZE - 1) / ECS_CACHE_LINE_SIZE * ECS_CACHE_LINE_SIZE;
+	}
+
+	Archetype::Archetype(Signature const& signature, std::array<ComponentManager, ECS_COMPONENT_MAX> const& managers)
+		: signature(signature), entityOffset(0), chunkCapacity(0), chunkBytes(0), size(0)
+	{
+		columnIndex.fill(ECS_COLUMN_NONE);
+
+		uint64_t rowBytes = sizeof(Entity);
+
+		for (uint64_t i = 0; i < ECS_COMPONENT_MAX; i++) {
+			if (!signature.test(i)) continue;
+
+			columnIndex[i] = static_cast<uint8_t>(componentIDs.size());
+			componentIDs.push_back(static_cast<uint8_t>(i));
+			columnManagers.push_back(managers[i]);
+
+			rowBytes += managers[i].typeSize;
+		}
+
+		// Leave room for aligning every column (and the entity column) to a cache line
+		uint64_t paddingBytes = ECS_CACHE_LINE_SIZE * (componentIDs.size() + 1);
+		chunkCapacity = ECS_CHUNK_SIZE > paddingBytes + rowBytes ? (ECS_CHUNK_SIZE - paddingBytes) / rowBytes : 1;
+
+		uint64_t offset = 0;
+
+		for (ComponentManager const& manager : columnManagers) {
+			columnOffsets.push_back(offset);
+			offset = _alignToCacheLine(offset + manager.typeSize * chunkCapacity);
+		}
+
+		entityOffset = offset;
+		chunkBytes = _alignToCacheLine(offset + sizeof(Entity) * chunkCapacity);
+	}
+
+	Archetype::~Archetype()
+	{
+		for (ArchetypeChunk& chunk : chunks) {
+			for (uint64_t i = 0; i < columnManagers.size(); i++) {
+				columnManagers[i].destroyFunction(chunk.data + columnOffsets[i], chunk.count);
+			}
+
+			::operator delete[](chunk.data, std::align_val_t(ECS_CACHE_LINE_SIZE));
+		}
+	}
+
+	uint64_t Archetype::pushRow(Entity entity)
+	{
+		if (size == chunks.size() * chunkCapacity) {
+			ArchetypeChunk chunk;
+			chunk.data = static_cast<uint8_t*>(::operator new[](chunkBytes, std::align_val_t(ECS_CACHE_LINE_SIZE)));
+			chunk.count = 0;
+
+			chunks.push_back(chunk);
+		}
+
+		uint64_t row = size++;
+
+		ArchetypeChunk& chunk = chunks[row / chunkCapacity];
+		getEntities(chunk)[chunk.count++] = entity;
+
+		return row;
+	}
+
+	Entity Archetype::removeRow(uint64_t row)
+	{
+		uint64_t lastRow = --size;
+		Entity movedEntity = ECS_ENTITY_DEAD;
+
+		if (row != lastRow) {
+			for (uint64_t i = 0; i < columnManagers.size(); i++) {
+				void* last = getComponent(lastRow, static_cast<uint8_t>(i));
+
+				columnManagers[i].moveFunction(last, getComponent(row, static_cast<uint8_t>(i)));
+				columnManagers[i].destroyFunction(last, 1);
+			}
+
+			movedEntity = getEntity(lastRow);
+			getEntity(row) = movedEntity;
+		}
+
+		ArchetypeChunk& lastChunk = chunks.back();
+
+		// Release chunk once emptied
+		if (--lastChunk.count == 0) {
+			::operator delete[](lastChunk.data, std::align_val_t(ECS_CACHE_LINE_SIZE));
+
+			chunks.pop_back();
+		}
+
+		return movedEntity;
+	}
+
+	void* Archetype::getComponent(uint64_t row, uint8_t column)
+	{
+		ArchetypeChunk& chunk = chunks[row / chunkCapacity];
+
+		return chunk.data + columnOffsets[column] + (row % chunkCapacity) * columnManagers[column].typeSize;
+	}
+
+	Entity& Archetype::getEntity(uint64_t row)
+	{
+		return getEntities(chunks[row / chunkCapacity])[row % chunkCapacity];
+	}
+
+	Entity* Archetype::getEntities(ArchetypeChunk const& chunk)
+	{
+		return reinterpret_cast<Entity*>(chunk.data + entityOffset);
+	}
+
+	ArchetypeRegistry::ArchetypeRegistry()
+		: locations(ArchetypeLocation{ nullptr, 0 })
+	{
+		emptyArchetype = _getArchetype(Signature{});
+	}
+
+	ArchetypeRegistry::~ArchetypeRegistry()
+	{
+		for (Archetype* archetype : archetypes) {
+			delete archetype;
+		}
+	}
+
+	Entity ArchetypeRegistry::create()
+	{
+		Entity entity = entityAllocator.create();
+
+		locations.set(getIdentifier(entity), ArchetypeLocation{ emptyArchetype, emptyArchetype->pushRow(entity) });
+
+		return entity;
+	}
+
+	void ArchetypeRegistry::createMany(uint64_t count, std::span<Entity> out)
+	{
+		entityAllocator.createMany(count, out);
+
+		for (uint64_t i = 0; i < count; i++) {
+			locations.set(getIdentifier(out[i]), ArchetypeLocation{ emptyArchetype, emptyArchetype->pushRow(out[i]) });
+		}
+	}
+
+	void ArchetypeRegistry::free(Entity entity)
+	{
+		if (!valid(entity)) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Freed invalid entity {}", entity);
+
+			return;
+		}
+
+		ArchetypeLocation location = locations.get(getIdentifier(entity));
+		Archetype* archetype = location.archetype;
+
+		for (uint64_t i = 0; i < archetype->columnManagers.size(); i++) {
+			archetype->columnManagers[i].destroyFunction(archetype->getComponent(location.row, static_cast<uint8_t>(i)), 1);
+		}
+
+		_removeRow(archetype, location.row);
+
+		locations.reset(getIdentifier(entity));
+
+		entityAllocator.free(entity);
+	}
+
+	void ArchetypeRegistry::clear()
+	{
+		for (Archetype* archetype : archetypes) {
+			delete archetype;
+		}
+
+		archetypes = {};
+		archetypeLookup = {};
+
+		entityAllocator.clear();
+		locations.clear();
+
+		emptyArchetype = _getArchetype(Signature{});
+	}
+
+	bool ArchetypeRegistry::valid(Entity entity) const
+	{
+		return entityAllocator.valid(entity);
+	}
+
+	Archetype* ArchetypeRegistry::_getArchetype(Signature const& signature)
+	{
+		auto it = archetypeLookup.find(signature);
+
+		if (it != archetypeLookup.end()) return it->second;
+
+		Archetype* archetype = new Archetype(signature, managers);
+
+		archetypes.push_back(archetype);
+		archetypeLookup[signature] = archetype;
+
+		return archetype;
+	}
+
+	Archetype* ArchetypeRegistry::_addTransition(Archetype* source, uint8_t componentID)
+	{
+		auto it = source->addEdges.find(componentID);
+
+		if (it != source->addEdges.end()) return it->second;
+
+		Signature signature = source->signature;
+		signature.set(componentID);
+
+		Archetype* destination = _getArchetype(signature);
+
+		source->addEdges[componentID] = destination;
+		destination->removeEdges[componentID] = source;
+
+		return destination;
+	}
+
+	Archetype* ArchetypeRegistry::_removeTransition(Archetype* source, uint8_t componentID)
+	{
+		auto it = source->removeEdges.find(componentID);
+
+		if (it != source->removeEdges.end()) return it->second;
+
+		Signature signature = source->signature;
+		signature.set(componentID, 0);
+
+		Archetype* destination = _getArchetype(signature);
+
+		source->removeEdges[componentID] = destination;
+		destination->addEdges[componentID] = source;
+
+		return destination;
+	}
+
+	uint64_t ArchetypeRegistry::_moveEntity(Entity entity, Archetype* destination)
+	{
+		ArchetypeLocation location = locations.get(getIdentifier(entity));
+		Archetype* source = location.archetype;
+		uint64_t sourceRow = location.row;
+
+		uint64_t row = destination->pushRow(entity);
+
+		for (uint64_t i = 0; i < source->componentIDs.size(); i++) {
+			void* component = source->getComponent(sourceRow, static_cast<uint8_t>(i));
+			uint8_t destinationColumn = destination->columnIndex[source->componentIDs[i]];
+
+			if (destinationColumn != ECS_COLUMN_NONE) {
+				source->columnManagers[i].moveFunction(component, destination->getComponent(row, destinationColumn));
+			}
+
+			source->columnManagers[i].destroyFunction(component, 1);
+		}
+
+		_removeRow(source, sourceRow);
+
+		locations.set(getIdentifier(entity), ArchetypeLocation{ destination, row });
+
+		return row;
+	}
+
+	void ArchetypeRegistry::_removeRow(Archetype* archetype, uint64_t row)
+	{
+		Entity movedEntity = archetype->removeRow(row);
+
+		if (movedEntity != ECS_ENTITY_DEAD) {
+			locations.index(getIdentifier(movedEntity)).row = row;
+		}
+	}
+}
\ No newline at end of file
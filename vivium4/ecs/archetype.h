@@ -0,0 +1,269 @@
+#pragma once
+
+#include "component_manager.h"
+#include "defines.h"
+#include "entity_allocator.h"
+#include "group.h"
+#include "paged_array.h"
+#include "../error/log.h"
+
+#include <array>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Vivium {
+	constexpr uint64_t ECS_CHUNK_SIZE = 16384U;
+	constexpr uint8_t ECS_COLUMN_NONE = 0xff;
+
+	// Fixed-size block of rows of an archetype, stored as one packed column per component (SoA)
+	//	followed by the entity column
+	struct ArchetypeChunk {
+		uint8_t* data;
+		uint64_t count;
+	};
+
+	// Storage for all entities with exactly the same signature
+	struct Archetype {
+		Signature signature;
+
+		// Column i stores component componentIDs[i]
+		std::vector<uint8_t> componentIDs;
+		std::vector<ComponentManager> columnManagers;
+		std::vector<uint64_t> columnOffsets;
+		uint64_t entityOffset;
+		// Component ID to column, ECS_COLUMN_NONE if not in archetype
+		std::array<uint8_t, ECS_COMPONENT_MAX> columnIndex;
+
+		uint64_t chunkCapacity;
+		uint64_t chunkBytes;
+		uint64_t size;
+
+		std::vector<ArchetypeChunk> chunks;
+
+		// Cached transitions when adding/removing a component
+		std::unordered_map<uint8_t, Archetype*> addEdges;
+		std::unordered_map<uint8_t, Archetype*> removeEdges;
+
+		Archetype(Signature const& signature, std::array<ComponentManager, ECS_COMPONENT_MAX> const& managers);
+		~Archetype();
+
+		Archetype(Archetype const&) = delete;
+		Archetype& operator=(Archetype const&) = delete;
+
+		// Allocates a row with uninitialised components
+		uint64_t pushRow(Entity entity);
+		// Relocates the last row into row, components of row must already be destroyed
+		// Returns the entity now at row, or ECS_ENTITY_DEAD if row was the last row
+		Entity removeRow(uint64_t row);
+
+		void* getComponent(uint64_t row, uint8_t column);
+		Entity& getEntity(uint64_t row);
+
+		template <typename T>
+		T* getColumn(ArchetypeChunk const& chunk) {
+			return reinterpret_cast<T*>(chunk.data + columnOffsets[columnIndex[TypeGenerator::getIdentifier<T>()]]);
+		}
+
+		Entity* getEntities(ArchetypeChunk const& chunk);
+	};
+
+	struct ArchetypeLocation {
+		Archetype* archetype;
+		uint64_t row;
+	};
+
+	struct ArchetypeRegistry;
+
+	// Query over all archetypes containing every component
+	// Ownership tags are accepted for parity with View, but have no effect: every archetype is packed
+	template <OwnershipTag... WrappedTypes>
+	struct ArchetypeView {
+		ArchetypeRegistry* registry;
+		Signature required;
+
+		std::vector<Archetype*> matchingArchetypes;
+		// Archetypes already tested against the query, new archetypes are only ever appended
+		uint64_t checkedArchetypes;
+
+		void _refresh();
+
+		// Column of T in chunk as a span, empty tuple for tags, which have no storage
+		template <typename T>
+		static auto _columnTuple(Archetype* archetype, ArchetypeChunk const& chunk);
+
+		// Calls function(std::span<Ts>..., std::span<const Entity>) for each non-empty chunk of every matching archetype
+		// Tags get no span, as in View::each
+		template <typename Function>
+		void each(Function&& function);
+	};
+
+	// Archetype-based storage, with the same surface as Registry
+	// Entities with identical signatures are stored together in chunks, so queries test archetype signatures
+	//	and iterate packed chunks, at the cost of moving rows between archetypes on add/remove
+	struct ArchetypeRegistry {
+		EntityAllocator entityAllocator;
+		PagedArray<ArchetypeLocation, ECS_PAGE_SIZE> locations;
+
+		std::array<ComponentManager, ECS_COMPONENT_MAX> managers;
+		Signature registeredComponents;
+
+		std::vector<Archetype*> archetypes;
+		std::unordered_map<Signature, Archetype*> archetypeLookup;
+		// Archetype of entities without components
+		Archetype* emptyArchetype;
+
+		ArchetypeRegistry();
+		~ArchetypeRegistry();
+
+		Entity create();
+		void createMany(uint64_t count, std::span<Entity> out);
+		void free(Entity entity);
+		// Invalidates all views, handles from before the clear stay invalid
+		void clear();
+		bool valid(Entity entity) const;
+
+		Archetype* _getArchetype(Signature const& signature);
+		Archetype* _addTransition(Archetype* source, uint8_t componentID);
+		Archetype* _removeTransition(Archetype* source, uint8_t componentID);
+		// Moves entity into destination, relocating shared components and destroying the rest
+		// Returns the new row of the entity
+		uint64_t _moveEntity(Entity entity, Archetype* destination);
+		// Removes row, fixing the location of the entity relocated into it
+		void _removeRow(Archetype* archetype, uint64_t row);
+
+		template <ValidComponent T>
+		void registerComponent() {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+
+			if (registeredComponents.test(componentID)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Already registered component");
+
+				return;
+			}
+
+			managers[componentID] = defaultComponentManager<T>();
+			registeredComponents.set(componentID);
+		}
+
+		template <ValidComponent T>
+		void addComponent(Entity entity, T&& component) {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+
+			if (!valid(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Added component to invalid entity {}", entity);
+
+				return;
+			}
+
+			if (!registeredComponents.test(componentID)) { registerComponent<T>(); }
+
+			Archetype* source = locations.get(getIdentifier(entity)).archetype;
+
+			if (source->columnIndex[componentID] != ECS_COLUMN_NONE) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
+
+				return;
+			}
+
+			Archetype* destination = _addTransition(source, componentID);
+			uint64_t row = _moveEntity(entity, destination);
+
+			new (destination->getComponent(row, destination->columnIndex[componentID])) T(std::forward<T>(component));
+		}
+
+		template <ValidComponent T>
+		void removeComponent(Entity entity) {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+
+			if (!valid(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Removed component from invalid entity {}", entity);
+
+				return;
+			}
+
+			Archetype* source = locations.get(getIdentifier(entity)).archetype;
+
+			if (source->columnIndex[componentID] == ECS_COLUMN_NONE) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity didn't have component");
+
+				return;
+			}
+
+			_moveEntity(entity, _removeTransition(source, componentID));
+		}
+
+		template <ValidComponent T>
+		T& getComponent(Entity entity) {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+			if (!entityAllocator.valid(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Stale entity handle");
+			}
+
+			ArchetypeLocation const& location = locations.get(getIdentifier(entity));
+
+			uint8_t column = location.archetype->columnIndex[componentID];
+
+			if (column == ECS_COLUMN_NONE) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity didn't have component");
+			}
+
+			return *reinterpret_cast<T*>(location.archetype->getComponent(location.row, column));
+		}
+
+		template <OwnershipTag... Components>
+		ArchetypeView<Components...> createView();
+	};
+
+	template <OwnershipTag... WrappedTypes>
+	void ArchetypeView<WrappedTypes...>::_refresh() {
+		for (; checkedArchetypes < registry->archetypes.size(); checkedArchetypes++) {
+			Archetype* archetype = registry->archetypes[checkedArchetypes];
+
+			if (archetype->signature.includes(required)) {
+				matchingArchetypes.push_back(archetype);
+			}
+		}
+	}
+
+	template <OwnershipTag... WrappedTypes>
+	template <typename T>
+	auto ArchetypeView<WrappedTypes...>::_columnTuple(Archetype* archetype, ArchetypeChunk const& chunk) {
+		if constexpr (std::is_empty_v<T>) {
+			return std::tuple<>();
+		}
+		else {
+			return std::tuple<std::span<T>>(std::span<T>(archetype->template getColumn<T>(chunk), chunk.count));
+		}
+	}
+
+	template <OwnershipTag... WrappedTypes>
+	template <typename Function>
+	void ArchetypeView<WrappedTypes...>::each(Function&& function) {
+		_refresh();
+
+		for (Archetype* archetype : matchingArchetypes) {
+			for (ArchetypeChunk const& chunk : archetype->chunks) {
+				if (chunk.count == 0) continue;
+
+				std::apply([archetype, &chunk, &function](auto... spans) {
+					function(spans..., std::span<const Entity>(archetype->getEntities(chunk), chunk.count));
+				}, std::tuple_cat(_columnTuple<typename WrappedTypes::type>(archetype, chunk)...));
+			}
+		}
+	}
+
+	template <OwnershipTag... Components>
+	ArchetypeView<Components...> ArchetypeRegistry::createView() {
+		ArchetypeView<Components...> view;
+		view.registry = this;
+		view.checkedArchetypes = 0;
+
+		view.required = Signature::of(TypeGenerator::getIdentifier<typename Components::type>()...);
+
+		view._refresh();
+
+		return view;
+	}
+}
\ No newline at end of file
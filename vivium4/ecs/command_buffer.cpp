@@ -0,0 +1,215 @@
+#include "command_buffer.h"
+
+namespace Vivium {
+	EntityCommandBuffer::EntityCommandBuffer()
+		: createCount(0)
+	{
+		componentCommands.fill(nullptr);
+	}
+
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		for (uint8_t componentID : usedComponents) {
+			ComponentCommands* commands = componentCommands[componentID];
+
+			commands->deleteFunction(commands->addComponents);
+
+			delete commands;
+		}
+	}
+
+	PendingEntity EntityCommandBuffer::create()
+	{
+		return PendingEntity{ createCount++ };
+	}
+
+	void EntityCommandBuffer::destroy(Entity entity)
+	{
+		destroyTargets.push_back(entity);
+	}
+
+	void EntityCommandBuffer::append(EntityCommandBuffer& other)
+	{
+		for (uint8_t componentID : other.usedComponents) {
+			ComponentCommands& source = *other.componentCommands[componentID];
+
+			if (componentCommands[componentID] == nullptr) {
+				componentCommands[componentID] = source.createFunction();
+				usedComponents.push_back(componentID);
+			}
+
+			ComponentCommands& destination = *componentCommands[componentID];
+
+			for (CommandTarget target : source.addTargets) {
+				if (target.pendingIndex != ECS_INDEX_NONE) {
+					target.pendingIndex += createCount;
+				}
+
+				target.sequence += destination.commandCount;
+				destination.addTargets.push_back(target);
+			}
+
+			for (CommandTarget target : source.removeTargets) {
+				target.sequence += destination.commandCount;
+				destination.removeTargets.push_back(target);
+			}
+
+			destination.appendFunction(destination.addComponents, source.addComponents);
+			destination.commandCount += source.commandCount;
+		}
+
+		createCount += other.createCount;
+		destroyTargets.insert(destroyTargets.end(), other.destroyTargets.begin(), other.destroyTargets.end());
+
+		other.clear();
+	}
+
+	std::vector<Entity> EntityCommandBuffer::playback(Registry& registry)
+	{
+		std::vector<Entity> createdEntities(createCount);
+		registry.createMany(createCount, createdEntities);
+
+		for (uint8_t componentID : usedComponents) {
+			_applyComponentCommands(registry, *componentCommands[componentID], createdEntities);
+		}
+
+		// Entities may be destroyed by several jobs, only free each once
+		std::sort(destroyTargets.begin(), destroyTargets.end());
+		destroyTargets.erase(std::unique(destroyTargets.begin(), destroyTargets.end()), destroyTargets.end());
+
+		for (Entity entity : destroyTargets) {
+			registry.free(entity);
+		}
+
+		clear();
+
+		return createdEntities;
+	}
+
+	void EntityCommandBuffer::clear()
+	{
+		createCount = 0;
+		destroyTargets.clear();
+
+		// Keep storage allocated, buffers are usually refilled every frame
+		for (uint8_t componentID : usedComponents) {
+			ComponentCommands& commands = *componentCommands[componentID];
+
+			commands.addTargets.clear();
+			commands.removeTargets.clear();
+			commands.commandCount = 0;
+			commands.clearFunction(commands.addComponents);
+		}
+	}
+
+	void EntityCommandBuffer::_applyComponentCommands(Registry& registry, ComponentCommands& commands, std::span<const Entity> createdEntities)
+	{
+		uint64_t addCount = commands.addTargets.size();
+		uint64_t commandCount = addCount + commands.removeTargets.size();
+
+		// Target of every command, additions first
+		std::vector<Entity> targets(commandCount);
+
+		for (uint64_t i = 0; i < addCount; i++) {
+			CommandTarget target = commands.addTargets[i];
+
+			targets[i] = target.pendingIndex == ECS_INDEX_NONE ? target.entity : createdEntities[target.pendingIndex];
+		}
+
+		for (uint64_t i = addCount; i < commandCount; i++) {
+			targets[i] = commands.removeTargets[i - addCount].entity;
+		}
+
+		// Batch each command goes in, an entity moves to the next batch whenever its commands switch
+		//	between adding and removing, so removing then re-adding the component keeps the new one
+		std::vector<uint32_t> batches(commandCount, 0);
+		uint32_t batchCount = 1;
+
+		if (addCount != 0 && addCount != commandCount) {
+			auto sequence = [&commands, addCount](uint64_t command) {
+				return command < addCount ? commands.addTargets[command].sequence : commands.removeTargets[command - addCount].sequence;
+			};
+
+			std::vector<uint32_t> order(commandCount);
+			std::iota(order.begin(), order.end(), 0U);
+			std::sort(order.begin(), order.end(), [&targets, &sequence](uint32_t a, uint32_t b) {
+				if (targets[a] != targets[b]) return targets[a] < targets[b];
+
+				return sequence(a) < sequence(b);
+			});
+
+			for (uint64_t i = 1; i < commandCount; i++) {
+				uint32_t previous = order[i - 1];
+				uint32_t current = order[i];
+
+				if (targets[previous] != targets[current]) continue;
+
+				bool switched = (previous < addCount) != (current < addCount);
+				batches[current] = batches[previous] + switched;
+				batchCount = std::max(batchCount, batches[current] + 1);
+			}
+		}
+
+		std::vector<Entity> batchTargets;
+		std::vector<uint32_t> batchIndices;
+
+		for (uint32_t batch = 0; batch < batchCount; batch++) {
+			batchTargets.clear();
+			batchIndices.clear();
+
+			for (uint32_t i = 0; i < addCount; i++) {
+				if (batches[i] != batch) continue;
+
+				batchTargets.push_back(targets[i]);
+				batchIndices.push_back(i);
+			}
+
+			if (!batchTargets.empty()) {
+				commands.applyAddFunction(registry, batchTargets, batchIndices, commands.addComponents);
+			}
+
+			batchTargets.clear();
+
+			for (uint64_t i = addCount; i < commandCount; i++) {
+				if (batches[i] == batch) batchTargets.push_back(targets[i]);
+			}
+
+			if (!batchTargets.empty()) {
+				std::sort(batchTargets.begin(), batchTargets.end(), [](Entity a, Entity b) {
+					return getIdentifier(a) < getIdentifier(b);
+				});
+
+				commands.applyRemoveFunction(registry, batchTargets);
+			}
+		}
+	}
+
+	ParallelCommandBuffer::ParallelCommandBuffer(JobSystem& jobSystem)
+		: jobSystem(&jobSystem)
+	{
+		for (uint32_t i = 0; i < jobSystem.getThreadCount(); i++) {
+			buffers.push_back(std::make_unique<EntityCommandBuffer>());
+		}
+	}
+
+	EntityCommandBuffer& ParallelCommandBuffer::local()
+	{
+		return *buffers[jobSystem->getThreadIndex()];
+	}
+
+	std::vector<Entity> ParallelCommandBuffer::playback(Registry& registry)
+	{
+		for (uint64_t i = 1; i < buffers.size(); i++) {
+			buffers.front()->append(*buffers[i]);
+		}
+
+		return buffers.front()->playback(registry);
+	}
+
+	void ParallelCommandBuffer::clear()
+	{
+		for (std::unique_ptr<EntityCommandBuffer>& buffer : buffers) {
+			buffer->clear();
+		}
+	}
+}
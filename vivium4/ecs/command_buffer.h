@@ -0,0 +1,191 @@
+#pragma once
+
+#include "registry.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+namespace Vivium {
+	// Entity created through a command buffer, only given an Entity on playback
+	struct PendingEntity {
+		uint32_t index;
+	};
+
+	struct CommandTarget {
+		Entity entity;
+		// Index of a PendingEntity, or ECS_INDEX_NONE if entity is already valid
+		uint32_t pendingIndex;
+		// Order the command was recorded in, among commands for the same component
+		uint32_t sequence;
+	};
+
+	// Additions and removals of a single component type recorded by a buffer
+	struct ComponentCommands {
+		typedef ComponentCommands*(*CreateFunction)();
+		// Adds component indices[i] of the storage to entities[i]
+		typedef void(*ApplyAddFunction)(Registry&, std::span<const Entity>, std::span<const uint32_t>, void*);
+		typedef void(*ApplyRemoveFunction)(Registry&, std::span<const Entity>);
+		// Moves all components of the source storage onto the end of the destination storage
+		typedef void(*AppendFunction)(void*, void*);
+		typedef void(*ClearFunction)(void*);
+		typedef void(*DeleteFunction)(void*);
+
+		std::vector<CommandTarget> addTargets;
+		// std::vector<T>, aligned with addTargets
+		void* addComponents;
+		std::vector<CommandTarget> removeTargets;
+		// Additions and removals recorded, the next sequence number
+		uint32_t commandCount;
+
+		// Creates empty commands of the same component type
+		CreateFunction createFunction;
+		ApplyAddFunction applyAddFunction;
+		ApplyRemoveFunction applyRemoveFunction;
+		AppendFunction appendFunction;
+		ClearFunction clearFunction;
+		DeleteFunction deleteFunction;
+	};
+
+	template <ValidComponent T>
+	void _applyAddCommands(Registry& registry, std::span<const Entity> entities, std::span<const uint32_t> indices, void* components) {
+		std::vector<T>& typedComponents = *static_cast<std::vector<T>*>(components);
+
+		// Sort by identifier, so the sparse pages of the pool are written in order
+		std::vector<uint32_t> order(entities.size());
+		std::iota(order.begin(), order.end(), 0U);
+		std::sort(order.begin(), order.end(), [entities](uint32_t a, uint32_t b) {
+			return getIdentifier(entities[a]) < getIdentifier(entities[b]);
+		});
+
+		std::vector<Entity> sortedEntities;
+		std::vector<T> sortedComponents;
+		sortedEntities.reserve(order.size());
+		sortedComponents.reserve(order.size());
+
+		for (uint32_t index : order) {
+			sortedEntities.push_back(entities[index]);
+			sortedComponents.push_back(std::move(typedComponents[indices[index]]));
+		}
+
+		registry.addComponents<T>(sortedEntities, sortedComponents);
+	}
+
+	template <ValidComponent T>
+	ComponentCommands* _createComponentCommands() {
+		ComponentCommands* commands = new ComponentCommands;
+		commands->addComponents = new std::vector<T>();
+		commands->commandCount = 0;
+
+		commands->createFunction = _createComponentCommands<T>;
+		commands->applyAddFunction = _applyAddCommands<T>;
+		commands->applyRemoveFunction = [](Registry& registry, std::span<const Entity> entities) {
+			registry.removeComponents<T>(entities);
+		};
+		commands->appendFunction = [](void* destination, void* source) {
+			std::vector<T>& typedDestination = *static_cast<std::vector<T>*>(destination);
+			std::vector<T>& typedSource = *static_cast<std::vector<T>*>(source);
+
+			typedDestination.insert(typedDestination.end(), std::make_move_iterator(typedSource.begin()), std::make_move_iterator(typedSource.end()));
+			typedSource.clear();
+		};
+		commands->clearFunction = [](void* components) {
+			static_cast<std::vector<T>*>(components)->clear();
+		};
+		commands->deleteFunction = [](void* components) {
+			delete static_cast<std::vector<T>*>(components);
+		};
+
+		return commands;
+	}
+
+	// Records structural changes (create/destroy/add/remove) to apply to a registry later, so they
+	//	can be made while iterating a view, or from jobs
+	// Playback applies creations, then additions and removals, then destructions
+	// Additions and removals are batched per component, so each pool is reallocated and each
+	//	owning group partitioned once per playback, unless an entity both gains and loses the same
+	//	component, which then happens in the order recorded
+	struct EntityCommandBuffer {
+		uint32_t createCount;
+		std::vector<Entity> destroyTargets;
+
+		// Indexed by component ID, nullptr until a command for the component is recorded
+		std::array<ComponentCommands*, ECS_COMPONENT_MAX> componentCommands;
+		// IDs of components with commands, in order of first use
+		std::vector<uint8_t> usedComponents;
+
+		EntityCommandBuffer();
+		~EntityCommandBuffer();
+
+		EntityCommandBuffer(EntityCommandBuffer const&) = delete;
+		EntityCommandBuffer& operator=(EntityCommandBuffer const&) = delete;
+
+		PendingEntity create();
+		void destroy(Entity entity);
+
+		template <ValidComponent T>
+		void addComponent(Entity entity, T&& component) {
+			_addComponent<T>(entity, ECS_INDEX_NONE, std::forward<T>(component));
+		}
+
+		template <ValidComponent T>
+		void addComponent(PendingEntity entity, T&& component) {
+			_addComponent<T>(ECS_ENTITY_DEAD, entity.index, std::forward<T>(component));
+		}
+
+		template <ValidComponent T>
+		void removeComponent(Entity entity) {
+			ComponentCommands& commands = _getCommands<T>();
+
+			commands.removeTargets.push_back(CommandTarget{ entity, ECS_INDEX_NONE, commands.commandCount++ });
+		}
+
+		// Moves all commands of other into this buffer, after the commands already recorded
+		// Pending entities of other are renumbered to follow those of this buffer
+		void append(EntityCommandBuffer& other);
+		// Applies and clears all commands
+		// Returns the entities created, indexed by PendingEntity::index
+		std::vector<Entity> playback(Registry& registry);
+		void clear();
+
+		// Applies the additions and removals of one component, entities with both get them split
+		//	into consecutive batches, so each sees its commands in recorded order
+		void _applyComponentCommands(Registry& registry, ComponentCommands& commands, std::span<const Entity> createdEntities);
+
+		template <ValidComponent T>
+		void _addComponent(Entity entity, uint32_t pendingIndex, T&& component) {
+			ComponentCommands& commands = _getCommands<T>();
+
+			commands.addTargets.push_back(CommandTarget{ entity, pendingIndex, commands.commandCount++ });
+			static_cast<std::vector<T>*>(commands.addComponents)->push_back(std::forward<T>(component));
+		}
+
+		template <ValidComponent T>
+		ComponentCommands& _getCommands() {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+
+			if (componentCommands[componentID] == nullptr) {
+				componentCommands[componentID] = _createComponentCommands<T>();
+				usedComponents.push_back(componentID);
+			}
+
+			return *componentCommands[componentID];
+		}
+	};
+
+	// One command buffer per thread of a job system, so jobs record without synchronisation
+	// Playback merges every buffer, and applies them as a single batch
+	struct ParallelCommandBuffer {
+		JobSystem* jobSystem;
+		std::vector<std::unique_ptr<EntityCommandBuffer>> buffers;
+
+		ParallelCommandBuffer(JobSystem& jobSystem);
+
+		// Buffer of the calling thread
+		EntityCommandBuffer& local();
+
+		// Returns the entities created, in order of thread index, then creation
+		std::vector<Entity> playback(Registry& registry);
+		void clear();
+	};
+}
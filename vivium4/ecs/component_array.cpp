@@ -2,15 +2,30 @@
 
 namespace Vivium {
 	ComponentArray::ComponentArray()
-		: sparse(ECS_ENTITY_DEAD), dense(nullptr), entities(nullptr), size(0), capacity(0), owner(nullptr)
+		: sparse(ECS_INDEX_NONE), dense(nullptr), entities(nullptr), size(0), capacity(0),
+		addedTicks(nullptr), changedTicks(nullptr)
 	{}
 
 	ComponentArray::~ComponentArray()
 	{
 		clear();
 
-		delete[] dense;
+		_freeDense(dense);
 		delete[] entities;
+		delete[] addedTicks;
+		delete[] changedTicks;
+	}
+
+	uint8_t* ComponentArray::_allocateDense(uint64_t bytes)
+	{
+		return static_cast<uint8_t*>(::operator new[](bytes, std::align_val_t(ECS_CACHE_LINE_SIZE)));
+	}
+
+	void ComponentArray::_freeDense(uint8_t* data)
+	{
+		if (data == nullptr) return;
+
+		::operator delete[](data, std::align_val_t(ECS_CACHE_LINE_SIZE));
 	}
 
 	void ComponentArray::_allocateForIndex(uint64_t index) {
@@ -19,9 +34,8 @@ namespace Vivium {
 		}
 	}
 
-	void ComponentArray::resize(uint64_t newCapacity) {
-		if (newCapacity <= capacity) { return; }
-
+	void ComponentArray::_resizeEntities(uint64_t newCapacity)
+	{
 		Entity* newEntities = new Entity[newCapacity];
 		if (entities != nullptr)
 		{
@@ -35,22 +49,72 @@ namespace Vivium {
 		}
 
 		entities = newEntities;
+	}
 
-		uint8_t* newDense = new uint8_t[newCapacity * manager.typeSize];
-		if (dense != nullptr)
-		{
-			manager.reallocFunction(dense, newDense, size);
+	void ComponentArray::_resizeTicks(uint64_t newCapacity)
+	{
+		if (changedTicks == nullptr) return;
 
-			delete[] dense;
-		}
+		uint32_t* newAddedTicks = new uint32_t[newCapacity];
+		uint32_t* newChangedTicks = new uint32_t[newCapacity];
+
+		std::memcpy(newAddedTicks, addedTicks, size * sizeof(uint32_t));
+		std::memcpy(newChangedTicks, changedTicks, size * sizeof(uint32_t));
+
+		delete[] addedTicks;
+		delete[] changedTicks;
+
+		addedTicks = newAddedTicks;
+		changedTicks = newChangedTicks;
+	}
+
+	void ComponentArray::resize(uint64_t newCapacity) {
+		if (newCapacity <= capacity) { return; }
+
+		_resizeEntities(newCapacity);
+		_resizeTicks(newCapacity);
 
-		dense = newDense;
+		// Tags have no dense storage
+		if (manager.typeSize > 0) {
+			uint8_t* newDense = _allocateDense(newCapacity * manager.typeSize);
+			if (dense != nullptr)
+			{
+				manager.reallocFunction(dense, newDense, size);
+
+				_freeDense(dense);
+			}
+
+			dense = newDense;
+		}
 
 		capacity = newCapacity;
 	}
 
 	bool ComponentArray::contains(Entity entity) {
-		return sparse.get(getIdentifier(entity)) != ECS_ENTITY_DEAD;
+		uint32_t index = sparse.get(getIdentifier(entity));
+
+		// Dense entities hold the full handle, so stale versions don't match
+		return index != ECS_INDEX_NONE && entities[index] == entity;
+	}
+
+	void ComponentArray::push(Entity entity, void* component)
+	{
+		if (sparse.get(getIdentifier(entity)) != ECS_INDEX_NONE) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
+
+			return;
+		}
+
+		uint32_t index = size;
+		sparse.set(getIdentifier(entity), index);
+
+		_allocateForIndex(index);
+
+		entities[index] = entity;
+
+		manager.moveFunction(component, &dense[index * manager.typeSize]);
+
+		++size;
 	}
 
 	void ComponentArray::swap(Entity a, Entity b) {
@@ -61,32 +125,145 @@ namespace Vivium {
 			&dense[indexA * manager.typeSize],
 			&dense[indexB * manager.typeSize]
 		);
+		_swapTicks(indexA, indexB);
 
 		std::swap(entities[indexA], entities[indexB]);
 		std::swap(indexA, indexB);
 	}
 
+	void ComponentArray::permute(uint64_t begin, std::span<const uint32_t> order)
+	{
+		manager.permuteFunction(&dense[begin * manager.typeSize], order.data(), order.size());
+		_permuteInPlace(entities + begin, order.data(), order.size());
+
+		if (changedTicks != nullptr) {
+			_permuteInPlace(addedTicks + begin, order.data(), order.size());
+			_permuteInPlace(changedTicks + begin, order.data(), order.size());
+		}
+
+		for (uint64_t i = begin; i < begin + order.size(); i++) {
+			sparse.index(getIdentifier(entities[i])) = static_cast<uint32_t>(i);
+		}
+	}
+
 	void ComponentArray::free(Entity entity) {
-		uint32_t& index = sparse.index(getIdentifier(entity));
+		uint32_t index = sparse.get(getIdentifier(entity));
+		uint64_t lastIndex = size - 1;
+
+		// Move to back, so destroying leaves the array packed
+		if (index != lastIndex) {
+			swap(entity, entities[lastIndex]);
+		}
 
-		manager.destroyFunction(&dense[index * manager.typeSize], 1);
+		manager.destroyFunction(&dense[lastIndex * manager.typeSize], 1);
 
-		swap(index, size - 1);
-		index = ECS_ENTITY_DEAD;
+		entities[lastIndex] = ECS_ENTITY_DEAD;
+		sparse.reset(getIdentifier(entity));
 
 		--size;
 	}
-	
-	void ComponentArray::clear()
+
+	void ComponentArray::_removeAll()
 	{
 		manager.destroyFunction(dense, size);
+		std::fill(entities, entities + size, ECS_ENTITY_DEAD);
+		sparse.clear();
 
 		size = 0;
-		owner = nullptr;
 	}
-	
+
+	void ComponentArray::clear()
+	{
+		_removeAll();
+
+		owners.clear();
+	}
+
 	bool ComponentArray::isOwned() const
 	{
-		return owner != nullptr;
+		return !owners.empty();
+	}
+
+	uint64_t ComponentArray::sparseMemoryUsage() const
+	{
+		return sparse.memoryUsage();
+	}
+
+	uint64_t ComponentArray::denseMemoryUsage() const
+	{
+		uint64_t tickBytes = changedTicks == nullptr ? 0 : capacity * sizeof(uint32_t) * 2;
+
+		return capacity * (manager.typeSize + sizeof(Entity)) + tickBytes;
+	}
+
+	void ComponentArray::enableTracking(uint32_t tick)
+	{
+		if (changedTicks != nullptr) return;
+
+		addedTicks = new uint32_t[std::max<uint64_t>(capacity, 1)];
+		changedTicks = new uint32_t[std::max<uint64_t>(capacity, 1)];
+
+		_stampAdded(0, size, tick);
+	}
+
+	bool ComponentArray::isTracked() const
+	{
+		return changedTicks != nullptr;
+	}
+
+	void ComponentArray::snapshot(Serialiser& store) const
+	{
+		uint8_t tracked = isTracked();
+
+		store.writeBytes(sizeof(uint64_t), &size);
+		store.writeBytes(sizeof(uint8_t), &tracked);
+
+		if (size > 0) {
+			manager.snapshotFunction(dense, size, store);
+			store.writeBytes(size * sizeof(Entity), entities);
+
+			if (tracked) {
+				store.writeBytes(size * sizeof(uint32_t), addedTicks);
+				store.writeBytes(size * sizeof(uint32_t), changedTicks);
+			}
+		}
+
+		sparse.snapshot(store);
+	}
+
+	void ComponentArray::restore(Serialiser& store)
+	{
+		_removeAll();
+
+		uint64_t newSize;
+		uint8_t tracked;
+
+		store.readBytes(sizeof(uint64_t), &newSize);
+		store.readBytes(sizeof(uint8_t), &tracked);
+
+		resize(newSize);
+
+		if (tracked) {
+			enableTracking(0);
+		}
+
+		if (newSize > 0) {
+			manager.restoreFunction(dense, newSize, store);
+			store.readBytes(newSize * sizeof(Entity), entities);
+
+			if (tracked) {
+				store.readBytes(newSize * sizeof(uint32_t), addedTicks);
+				store.readBytes(newSize * sizeof(uint32_t), changedTicks);
+			}
+		}
+
+		size = newSize;
+
+		// Pool was tracked but the snapshot wasn't, treat everything as unchanged
+		if (!tracked) {
+			_stampAdded(0, size, 0);
+		}
+
+		sparse.restore(store);
 	}
 }
\ No newline at end of file
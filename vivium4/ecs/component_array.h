@@ -5,13 +5,57 @@
 #include "paged_array.h"
 #include "../error/log.h"
 #include "group.h"
+#include "signal.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <span>
 #include <vector>
 
 namespace Vivium {
+	enum class SortMode {
+		// std::sort, for arbitrary orderings
+		FULL,
+		// Insertion sort, linear for ranges that are already nearly sorted (e.g. re-sorted every frame)
+		INSERTION
+	};
+
+	// Order of keys [0, count) sorted by compare, as indices into keys
+	template <typename Key, typename Compare>
+	std::vector<uint32_t> _sortOrder(Key const* keys, uint64_t count, Compare& compare, SortMode mode) {
+		std::vector<uint32_t> order(count);
+
+		for (uint64_t i = 0; i < count; i++) {
+			order[i] = static_cast<uint32_t>(i);
+		}
+
+		auto less = [keys, &compare](uint32_t a, uint32_t b) { return compare(keys[a], keys[b]); };
+
+		if (mode == SortMode::FULL) {
+			std::sort(order.begin(), order.end(), less);
+		}
+		else {
+			for (uint64_t i = 1; i < count; i++) {
+				uint32_t value = order[i];
+				uint64_t j = i;
+
+				for (; j > 0 && less(value, order[j - 1]); j--) {
+					order[j] = order[j - 1];
+				}
+
+				order[j] = value;
+			}
+		}
+
+		return order;
+	}
+
+	// Type-erased component storage, all operations go through the ComponentManager
+	//	function table, used only where the registry doesn't know the type (e.g. Registry::free)
 	struct ComponentArray {
-		PagedArray<Entity, ECS_PAGE_SIZE, ECS_ENTITY_MAX> sparse;
-		
+		PagedArray<uint32_t, ECS_PAGE_SIZE> sparse;
+
 		// Packed
 		uint8_t* dense;
 		Entity* entities;
@@ -19,56 +63,253 @@ namespace Vivium {
 		uint64_t size;
 		uint64_t capacity;
 
+		// Tick each component was added and last changed, aligned with dense
+		// nullptr unless change tracking was enabled for the pool
+		uint32_t* addedTicks;
+		uint32_t* changedTicks;
+
 		ComponentManager manager;
-		GroupMetadata* owner;
+		// Groups owning this pool, innermost (smallest range) first
+		std::vector<GroupMetadata*> owners;
+
+		// Published after a component is added, before one is removed, and when one is replaced or marked dirty
+		ComponentSignal constructSignal;
+		ComponentSignal destroySignal;
+		ComponentSignal updateSignal;
 
 		ComponentArray();
-		~ComponentArray();
+		virtual ~ComponentArray();
+
+		// Dense arrays are cache-line aligned, so chunks of ECS_CACHE_LINE_SIZE elements never share a cache line
+		static uint8_t* _allocateDense(uint64_t bytes);
+		static void _freeDense(uint8_t* data);
 
 		void _allocateForIndex(uint64_t index);
+		void _resizeEntities(uint64_t newCapacity);
+		void _resizeTicks(uint64_t newCapacity);
+
+		void _swapTicks(uint32_t indexA, uint32_t indexB) {
+			if (changedTicks == nullptr) return;
+
+			std::swap(addedTicks[indexA], addedTicks[indexB]);
+			std::swap(changedTicks[indexA], changedTicks[indexB]);
+		}
+
+		// Stamps components [begin, end) as added and changed in tick
+		void _stampAdded(uint64_t begin, uint64_t end, uint32_t tick) {
+			if (changedTicks == nullptr) return;
+
+			std::fill(addedTicks + begin, addedTicks + end, tick);
+			std::fill(changedTicks + begin, changedTicks + end, tick);
+		}
+
+		void _stampChanged(uint32_t index, uint32_t tick) {
+			if (changedTicks == nullptr) return;
+
+			changedTicks[index] = tick;
+		}
 
 		void resize(uint64_t newCapacity);
 		bool contains(Entity entity);
+		void push(Entity entity, void* component);
 		void swap(Entity a, Entity b);
+		// Reorders [begin, begin + order.size()) so element begin + i becomes the old element begin + order[i]
+		void permute(uint64_t begin, std::span<const uint32_t> order);
 		void free(Entity entity);
+		// Removes every component, keeping the allocation and group ownership
+		void _removeAll();
 		void clear();
 
 		bool isOwned() const;
 
-		template <ValidComponent T>
-		void push(Entity entity, T&& component) {
-			if (sparse.get(getIdentifier(entity)) != ECS_ENTITY_DEAD) {
-				VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
+		uint64_t sparseMemoryUsage() const;
+		// Dense components, entities and change ticks
+		uint64_t denseMemoryUsage() const;
+
+		// Starts recording added/changed ticks, existing components are stamped with tick
+		void enableTracking(uint32_t tick);
+		bool isTracked() const;
+
+		// Streams dense components, entities, change ticks and sparse pages as raw blocks
+		// Components go through manager.snapshotFunction, which must not be nullptr
+		void snapshot(Serialiser& store) const;
+		// Replaces all components with those written by snapshot(), keeping group ownership
+		void restore(Serialiser& store);
+	};
+
+	// Component storage with a compile-time known type, used whenever the registry knows T,
+	//	so pushes, swaps and relocations compile to direct (inlineable) operations on T
+	// Adds no members, so it can always be handled through the type-erased ComponentArray
+	// Tags (empty types) only store the entity list and sparse set, every entity shares one instance
+	template <ValidComponent T>
+	struct TypedComponentArray : ComponentArray {
+		static constexpr bool isTag = std::is_empty_v<T>;
+
+		TypedComponentArray() { manager = defaultComponentManager<T>(); }
+
+		T* data() { return reinterpret_cast<T*>(dense); }
+
+		static T& _tagInstance() {
+			static T instance;
+
+			return instance;
+		}
+
+		void _allocateForIndex(uint64_t index) {
+			if (capacity <= index) {
+				resize(std::max(index + 1, capacity * 2));
+			}
+		}
+
+		void resize(uint64_t newCapacity) {
+			if (newCapacity <= capacity) { return; }
+
+			_resizeEntities(newCapacity);
+			_resizeTicks(newCapacity);
+
+			if constexpr (isTag) {
+				capacity = newCapacity;
 
 				return;
 			}
 
+			T* newDense = reinterpret_cast<T*>(_allocateDense(newCapacity * sizeof(T)));
+
+			if (dense != nullptr)
+			{
+				// Called directly, so it inlines
+				defaultReallocComponent<T>(dense, newDense, size);
+
+				_freeDense(dense);
+			}
+
+			dense = reinterpret_cast<uint8_t*>(newDense);
+
+			capacity = newCapacity;
+		}
+
+		// Constructs the component directly in its dense slot from arguments
+		template <typename... Args>
+		T& emplace(Entity entity, Args&&... arguments) {
+			if (sparse.get(getIdentifier(entity)) != ECS_INDEX_NONE) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
+
+				return get(entity);
+			}
+
 			uint32_t index = size;
-			sparse.index(getIdentifier(entity)) = index;
+			sparse.set(getIdentifier(entity), index);
 
 			_allocateForIndex(index);
 
 			entities[index] = entity;
-			
-			manager.moveFunction(&component, &dense[index * manager.typeSize]);
+
+			if constexpr (!isTag) {
+				new (data() + index) T(std::forward<Args>(arguments)...);
+			}
 
 			++size;
+
+			return _getIndex(index);
+		}
+
+		void push(Entity entity, T&& component) {
+			emplace(entity, std::move(component));
+		}
+
+		// Destroys the component, and constructs the replacement in the same slot
+		template <typename... Args>
+		T& replace(Entity entity, Args&&... arguments) {
+			T& component = get(entity);
+
+			if constexpr (!isTag) {
+				component.~T();
+				new (&component) T(std::forward<Args>(arguments)...);
+			}
+
+			return component;
+		}
+
+		// Pushes all components with a single relocation
+		// Entities that already had the component are skipped, the rest are appended in order, so the
+		//	entities inserted are entities[oldSize, size)
+		void pushMany(std::span<const Entity> newEntities, std::span<T> components) {
+			_allocateForIndex(size + newEntities.size() - 1);
+
+			uint64_t index = size;
+
+			for (uint64_t i = 0; i < newEntities.size(); i++) {
+				Entity entity = newEntities[i];
+
+				if (sparse.get(getIdentifier(entity)) != ECS_INDEX_NONE) {
+					VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
+
+					continue;
+				}
+
+				sparse.set(getIdentifier(entity), index);
+				entities[index] = entity;
+
+				if constexpr (!isTag) {
+					new (data() + index) T(std::move(components[i]));
+				}
+
+				++index;
+			}
+
+			size = index;
+		}
+
+		void swap(Entity a, Entity b) {
+			uint32_t& indexA = sparse.index(getIdentifier(a));
+			uint32_t& indexB = sparse.index(getIdentifier(b));
+
+			if constexpr (!isTag) {
+				std::swap(data()[indexA], data()[indexB]);
+			}
+
+			_swapTicks(indexA, indexB);
+
+			std::swap(entities[indexA], entities[indexB]);
+			std::swap(indexA, indexB);
+		}
+
+		void free(Entity entity) {
+			uint32_t index = sparse.get(getIdentifier(entity));
+			uint64_t lastIndex = size - 1;
+
+			// Move to back, so destroying leaves the array packed
+			if (index != lastIndex) {
+				swap(entity, entities[lastIndex]);
+			}
+
+			if constexpr (!isTag) {
+				data()[lastIndex].~T();
+			}
+
+			entities[lastIndex] = ECS_ENTITY_DEAD;
+			sparse.reset(getIdentifier(entity));
+
+			--size;
 		}
 
-		template <ValidComponent T>
 		T& get(Entity entity) {
-			uint32_t index = sparse.index(getIdentifier(entity));
+			uint32_t index = sparse.get(getIdentifier(entity));
 
-			if (index == ECS_ENTITY_DEAD) {
-				VIVIUM_LOG(LogSeverity::FATAL, "Entity didn't have component");
+			if (index == ECS_INDEX_NONE || entities[index] != entity) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity didn't have component, or was a stale handle");
 			}
 
-			return *reinterpret_cast<T*>(&dense[index * manager.typeSize]);
+			return _getIndex(index);
 		}
 
-		template <ValidComponent T>
 		T& _getIndex(uint32_t index) {
-			return *reinterpret_cast<T*>(&dense[index * manager.typeSize]);
+			if constexpr (isTag) {
+				return _tagInstance();
+			}
+			else {
+				return data()[index];
+			}
 		}
 	};
 }
\ No newline at end of file
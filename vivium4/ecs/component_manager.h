@@ -1,28 +1,43 @@
 #pragma once
 
 #include <concepts>
+#include <cstring>
+#include <vector>
 
 #include "defines.h"
 #include "../error/log.h"
+#include "../serialiser/serialiser.h"
 
 namespace Vivium {
 	template <typename T>
 	concept ValidComponent = std::is_default_constructible_v<T> && (std::is_trivial_v<T> || std::is_move_constructible_v<T> || std::is_copy_constructible_v<T>);
 
+	// Constructs dest from source, leaving source to be destroyed by the caller
+	// Moves whenever possible, only copying types that can't be moved
 	template <ValidComponent T>
 	void defaultMoveComponent(void* source, void* dest) {
-		if constexpr (std::is_trivial_v<T> || std::is_copy_constructible_v<T>) {
-			new (dest) T(*reinterpret_cast<T*>(source));
-		}
-		else if constexpr (std::is_move_constructible_v<T>) {
+		if constexpr (std::is_move_constructible_v<T>) {
 			new (dest) T(std::move(*reinterpret_cast<T*>(source)));
 		}
+		else {
+			new (dest) T(*reinterpret_cast<T*>(source));
+		}
 	}
 
+	// Relocates count components from source into uninitialised dest, destroying the sources
+	// Trivially copyable types are copied bytewise
 	template <ValidComponent T>
 	void defaultReallocComponent(void* source, void* dest, uint64_t count) {
-		for (uint64_t i = 0; i < count; i++) {
-			defaultMoveComponent<T>(reinterpret_cast<T*>(source) + i, reinterpret_cast<T*>(dest) + i);
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			std::memcpy(dest, source, count * sizeof(T));
+		}
+		else {
+			for (uint64_t i = 0; i < count; i++) {
+				T* sourceComponent = reinterpret_cast<T*>(source) + i;
+
+				defaultMoveComponent<T>(sourceComponent, reinterpret_cast<T*>(dest) + i);
+				sourceComponent->~T();
+			}
 		}
 	}
 
@@ -38,30 +53,133 @@ namespace Vivium {
 		std::swap(*reinterpret_cast<T*>(a), *reinterpret_cast<T*>(b));
 	}
 
+	// Reorders data so element i becomes the old element order[i], moving each element once
+	template <typename T>
+	void _permuteInPlace(T* data, uint32_t const* order, uint64_t count) {
+		std::vector<bool> placed(count, false);
+
+		for (uint64_t start = 0; start < count; start++) {
+			if (placed[start] || order[start] == start) continue;
+
+			// Follow the cycle through start
+			T temporary = std::move(data[start]);
+			uint64_t current = start;
+
+			while (order[current] != start) {
+				data[current] = std::move(data[order[current]]);
+				placed[current] = true;
+				current = order[current];
+			}
+
+			data[current] = std::move(temporary);
+			placed[current] = true;
+		}
+	}
+
+	template <ValidComponent T>
+	void defaultPermuteComponent(void* data, uint32_t const* order, uint64_t count) {
+		_permuteInPlace(reinterpret_cast<T*>(data), order, count);
+	}
+
+	// Non-trivially copyable components are snapshot through user overloads of
+	//	serialiseWrite(T const&, Serialiser&) and serialiseRead(T*, Serialiser&)
+	template <typename T>
+	concept SnapshotHookComponent = requires(T const& component, T* target, Serialiser& store) {
+		serialiseWrite(component, store);
+		serialiseRead(target, store);
+	};
+
+	template <ValidComponent T>
+	void defaultSnapshotComponent(void const* data, uint64_t count, Serialiser& store) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			store.writeBytes(count * sizeof(T), data);
+		}
+		else {
+			for (uint64_t i = 0; i < count; i++) {
+				serialiseWrite(reinterpret_cast<T const*>(data)[i], store);
+			}
+		}
+	}
+
+	// Constructs count components into uninitialised data
+	template <ValidComponent T>
+	void defaultRestoreComponent(void* data, uint64_t count, Serialiser& store) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			store.readBytes(count * sizeof(T), data);
+		}
+		else {
+			for (uint64_t i = 0; i < count; i++) {
+				T* component = new (reinterpret_cast<T*>(data) + i) T();
+
+				serialiseRead(component, store);
+			}
+		}
+	}
+
 	struct ComponentManager {
 		typedef void(*MoveFunction)(void* src, void* dst);
 		typedef void(*ReallocFunction)(void* src, void* dst, uint64_t);
 		typedef void(*DestroyFunction)(void*, uint64_t);
 		typedef void(*SwapFunction)(void*, void*);
+		typedef void(*PermuteFunction)(void*, uint32_t const*, uint64_t);
+		typedef void(*SnapshotFunction)(void const*, uint64_t, Serialiser&);
+		typedef void(*RestoreFunction)(void*, uint64_t, Serialiser&);
 		typedef uint32_t(*ComponentIDFunction)(void);
 
 		MoveFunction moveFunction;
 		ReallocFunction reallocFunction;
 		DestroyFunction destroyFunction;
 		SwapFunction swapFunction;
+		PermuteFunction permuteFunction;
+		// nullptr if the type can't be snapshot
+		SnapshotFunction snapshotFunction;
+		RestoreFunction restoreFunction;
 		ComponentIDFunction componentIDFunction;
 
 		uint64_t typeSize;
 	};
 
+	// Tags (empty types) have no dense storage, so every per-component operation is a no-op
+	template <ValidComponent T>
+	ComponentManager _tagComponentManager() {
+		ComponentManager manager;
+
+		manager.moveFunction = [](void*, void*) {};
+		manager.reallocFunction = [](void*, void*, uint64_t) {};
+		manager.destroyFunction = [](void*, uint64_t) {};
+		manager.swapFunction = [](void*, void*) {};
+		manager.permuteFunction = [](void*, uint32_t const*, uint64_t) {};
+		manager.snapshotFunction = [](void const*, uint64_t, Serialiser&) {};
+		manager.restoreFunction = [](void*, uint64_t, Serialiser&) {};
+		manager.componentIDFunction = TypeGenerator::getIdentifier<T>;
+		manager.typeSize = 0;
+
+		return manager;
+	}
+
 	template <ValidComponent T>
 	ComponentManager defaultComponentManager() {
+		if constexpr (std::is_empty_v<T>) {
+			return _tagComponentManager<T>();
+		}
+
 		ComponentManager manager;
 
 		manager.moveFunction = defaultMoveComponent<T>;
 		manager.reallocFunction = defaultReallocComponent<T>;
 		manager.destroyFunction = defaultDestroyComponent<T>;
 		manager.swapFunction = defaultSwapComponent<T>;
+		manager.permuteFunction = defaultPermuteComponent<T>;
+
+		if constexpr (std::is_trivially_copyable_v<T> || SnapshotHookComponent<T>) {
+			manager.snapshotFunction = defaultSnapshotComponent<T>;
+			manager.restoreFunction = defaultRestoreComponent<T>;
+		}
+		else {
+			manager.snapshotFunction = nullptr;
+			manager.restoreFunction = nullptr;
+		}
+
 		manager.componentIDFunction = TypeGenerator::getIdentifier<T>;
 		manager.typeSize = sizeof(T);
 
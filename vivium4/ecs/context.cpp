@@ -0,0 +1,19 @@
+#include "context.h"
+
+namespace Vivium {
+	Context::~Context()
+	{
+		clear();
+	}
+
+	void Context::clear()
+	{
+		for (Entry& entry : entries) {
+			if (entry.data == nullptr) continue;
+
+			entry.destroyFunction(entry.data);
+		}
+
+		entries = {};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "defines.h"
+
+#include <utility>
+#include <vector>
+
+namespace Vivium {
+	// Registry-wide singletons (frame-wide resources, settings, etc.), at most one of each type
+	// Indexed by ContextTypeGenerator identifier, so access is a bounds check and an indirection
+	struct Context {
+		struct Entry {
+			typedef void(*DestroyFunction)(void*);
+
+			void* data;
+			DestroyFunction destroyFunction;
+		};
+
+		std::vector<Entry> entries;
+
+		Context() = default;
+		~Context();
+
+		Context(Context const&) = delete;
+		Context& operator=(Context const&) = delete;
+
+		Entry& _getEntry(uint32_t identifier) {
+			if (identifier >= entries.size()) {
+				entries.resize(identifier + 1, Entry{ nullptr, nullptr });
+			}
+
+			return entries[identifier];
+		}
+
+		// Constructs T from arguments, replacing any existing T
+		// Arguments may refer to the existing T, and if construction throws it's kept
+		template <typename T, typename... Args>
+		T& emplace(Args&&... arguments) {
+			T* value = new T(std::forward<Args>(arguments)...);
+
+			// Looked up after construction, which may add entries
+			Entry& entry = _getEntry(ContextTypeGenerator::getIdentifier<T>());
+
+			if (entry.data != nullptr) {
+				entry.destroyFunction(entry.data);
+			}
+
+			entry.data = value;
+			entry.destroyFunction = [](void* data) { delete static_cast<T*>(data); };
+
+			return *value;
+		}
+
+		// Default constructs T on first access
+		template <typename T>
+		T& get() {
+			Entry& entry = _getEntry(ContextTypeGenerator::getIdentifier<T>());
+
+			if (entry.data == nullptr) {
+				return emplace<T>();
+			}
+
+			return *static_cast<T*>(entry.data);
+		}
+
+		template <typename T>
+		bool contains() const {
+			uint32_t identifier = ContextTypeGenerator::getIdentifier<T>();
+
+			return identifier < entries.size() && entries[identifier].data != nullptr;
+		}
+
+		template <typename T>
+		void erase() {
+			uint32_t identifier = ContextTypeGenerator::getIdentifier<T>();
+
+			if (identifier >= entries.size() || entries[identifier].data == nullptr) return;
+
+			entries[identifier].destroyFunction(entries[identifier].data);
+			entries[identifier] = Entry{ nullptr, nullptr };
+		}
+
+		void clear();
+	};
+}
\ No newline at end of file
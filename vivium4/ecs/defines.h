@@ -1,26 +1,57 @@
 #pragma once
 
-#include <bitset>
+#include "signature.h"
+
 #include <cstdint>
 
 namespace Vivium {
 	constexpr uint64_t ECS_PAGE_SIZE = 4096U;
+	// Alignment of packed component arrays
+	constexpr uint64_t ECS_CACHE_LINE_SIZE = 64U;
+
+	// Entities are an identifier in the low bits, and a version in the high bits, incremented each time
+	//	the identifier is recycled
+	// Defaults to 32-bit entities with 20-bit identifiers (~1M live entities) and 12-bit versions
+	// Define VIVIUM_ECS_64BIT_ENTITIES for 64-bit entities with 32-bit identifiers and 32-bit versions
+#if VIVIUM_ECS_64BIT_ENTITIES
+	typedef uint64_t Entity;
+	constexpr uint32_t ECS_IDENTIFIER_BITS = 32;
+#else
+	typedef uint32_t Entity;
+	constexpr uint32_t ECS_IDENTIFIER_BITS = 20;
+#endif
 
-	constexpr uint32_t ECS_ENTITY_MAX = 0xfffff;
-	constexpr uint32_t ECS_VERSION_MAX = 0xfff;
-	constexpr uint32_t ECS_ENTITY_DEAD = 0xffffffff;
+	constexpr Entity ECS_ENTITY_MASK = (Entity(1) << ECS_IDENTIFIER_BITS) - 1;
+	constexpr Entity ECS_VERSION_MASK = ~ECS_ENTITY_MASK;
+	constexpr uint32_t ECS_VERSION_SHIFT = ECS_IDENTIFIER_BITS;
 
-	constexpr uint32_t ECS_VERSION_MASK = 0xfff00000;
-	constexpr uint32_t ECS_VERSION_SHIFT = 20;
-	constexpr uint32_t ECS_ENTITY_MASK = 0x000fffff;
+	// Largest identifier and version are reserved, so no live entity is ever ECS_ENTITY_DEAD
+	constexpr Entity ECS_ENTITY_MAX = ECS_ENTITY_MASK;
+	constexpr Entity ECS_VERSION_MAX = ECS_VERSION_MASK >> ECS_VERSION_SHIFT;
+	constexpr Entity ECS_ENTITY_DEAD = ~Entity(0);
+
+	// Dense index of an entity not in a pool
+	constexpr uint32_t ECS_INDEX_NONE = 0xffffffff;
 
 	constexpr uint8_t ECS_COMPONENT_MAX = 0xff;
+	static_assert(ECS_COMPONENT_MAX <= ECS_SIGNATURE_BITS, "Signature too small for component count");
+	constexpr uint32_t ECS_GROUP_MAX = 64;
 
-	typedef uint32_t Entity;
-	typedef std::bitset<ECS_COMPONENT_MAX> Signature;
+	// Bit i refers to the i-th group of a registry
+	typedef uint64_t GroupMask;
 
-	uint32_t getVersion(Entity entity);
-	uint32_t getIdentifier(Entity entity);
+	// Inline, since every sparse lookup goes through these
+	constexpr uint32_t getVersion(Entity entity) {
+		return static_cast<uint32_t>((entity & ECS_VERSION_MASK) >> ECS_VERSION_SHIFT);
+	}
+
+	constexpr uint32_t getIdentifier(Entity entity) {
+		return static_cast<uint32_t>(entity & ECS_ENTITY_MASK);
+	}
+
+	constexpr Entity makeEntity(uint32_t identifier, uint32_t version) {
+		return (static_cast<Entity>(version) << ECS_VERSION_SHIFT) | identifier;
+	}
 
 	// TODO: use both
 	constexpr Entity nullEntity = ECS_ENTITY_MAX & ECS_ENTITY_MASK;
@@ -36,4 +67,16 @@ namespace Vivium {
 			return value;
 		}
 	};
+
+	// Separate from TypeGenerator, so registry context types don't use up component identifiers
+	struct ContextTypeGenerator {
+		static uint32_t createIdentifier();
+
+		template <typename>
+		static uint32_t getIdentifier() {
+			static const uint32_t value = createIdentifier();
+
+			return value;
+		}
+	};
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "entity_allocator.h"
+#include "../error/log.h"
+
+#include <algorithm>
+
+namespace Vivium {
+	Entity EntityAllocator::create()
+	{
+		if (availableEntities > 0) {
+			Entity recycled = nextEntity;
+			Entity& slot = entities[getIdentifier(recycled)];
+
+			// Slot holds the next link of the free list
+			nextEntity = slot;
+			slot = recycled;
+			--availableEntities;
+
+			return recycled;
+		}
+
+		if (nextLargestEntity >= ECS_ENTITY_MAX) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Exceeded maximum entity count {}", ECS_ENTITY_MAX);
+
+			return ECS_ENTITY_DEAD;
+		}
+
+		entities.push_back(nextLargestEntity);
+		return nextLargestEntity++;
+	}
+
+	void EntityAllocator::createMany(uint64_t count, std::span<Entity> out)
+	{
+		if (out.size() < count) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Output span too small for {} entities", count);
+
+			return;
+		}
+
+		uint64_t recycledCount = std::min<uint64_t>(count, availableEntities);
+
+		// Walk the implicit free list
+		for (uint64_t i = 0; i < recycledCount; i++) {
+			Entity recycled = nextEntity;
+			Entity& slot = entities[getIdentifier(recycled)];
+
+			nextEntity = slot;
+			slot = recycled;
+
+			out[i] = recycled;
+		}
+
+		availableEntities -= recycledCount;
+
+		if (nextLargestEntity + (count - recycledCount) > ECS_ENTITY_MAX) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Exceeded maximum entity count {}", ECS_ENTITY_MAX);
+
+			return;
+		}
+
+		// Remaining are new entities
+		entities.reserve(entities.size() + count - recycledCount);
+
+		for (uint64_t i = recycledCount; i < count; i++) {
+			entities.push_back(nextLargestEntity);
+			out[i] = nextLargestEntity++;
+		}
+	}
+
+	void EntityAllocator::free(Entity entity)
+	{
+		if (!valid(entity)) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Freed invalid entity {}", entity);
+
+			return;
+		}
+
+		++availableEntities;
+
+		// Skips ECS_VERSION_MAX, so ECS_ENTITY_DEAD is never handed out
+		uint32_t version = static_cast<uint32_t>((getVersion(entity) + 1) % ECS_VERSION_MAX);
+
+		// Slot becomes the head of the implicit free list
+		entities[getIdentifier(entity)] = nextEntity;
+		nextEntity = makeEntity(getIdentifier(entity), version);
+	}
+
+	void EntityAllocator::snapshot(Serialiser& store) const
+	{
+		uint64_t count = entities.size();
+
+		store.writeBytes(sizeof(Entity), &nextEntity);
+		store.writeBytes(sizeof(Entity), &nextLargestEntity);
+		store.writeBytes(sizeof(uint64_t), &availableEntities);
+		store.writeBytes(sizeof(uint64_t), &count);
+		store.writeBytes(count * sizeof(Entity), entities.data());
+	}
+
+	void EntityAllocator::restore(Serialiser& store)
+	{
+		uint64_t count;
+
+		store.readBytes(sizeof(Entity), &nextEntity);
+		store.readBytes(sizeof(Entity), &nextLargestEntity);
+		store.readBytes(sizeof(uint64_t), &availableEntities);
+		store.readBytes(sizeof(uint64_t), &count);
+
+		entities.resize(count);
+		store.readBytes(count * sizeof(Entity), entities.data());
+	}
+
+	void EntityAllocator::clear()
+	{
+		for (uint64_t i = 0; i < entities.size(); i++) {
+			if (getIdentifier(entities[i]) == i) {
+				free(entities[i]);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "defines.h"
+#include "../serialiser/serialiser.h"
+
+#include <span>
+#include <vector>
+
+namespace Vivium {
+	// Hands out entity identifiers, recycling freed identifiers with an incremented version
+	// Versions wrap around before ECS_VERSION_MAX, so a handle only aliases a live entity after its
+	//	identifier has been recycled ECS_VERSION_MAX times
+	// Shared by every storage backend
+	struct EntityAllocator {
+		// Next to be recycled
+		Entity nextEntity = ECS_ENTITY_MAX;
+		// Next new available
+		Entity nextLargestEntity = 0;
+		uint64_t availableEntities = 0;
+
+		// All alive/dead entities, dead entities form an implicit free list through their identifiers
+		std::vector<Entity> entities;
+
+		Entity create();
+		// Creates count entities into out, recycling freed entities first
+		void createMany(uint64_t count, std::span<Entity> out);
+		void free(Entity entity);
+		// Frees every live entity, so handles from before the clear stay invalid
+		void clear();
+
+		// Streams the free list state and all slots as a raw block
+		void snapshot(Serialiser& store) const;
+		// Replaces all entities with those written by snapshot()
+		void restore(Serialiser& store);
+
+		// If entity is alive, and not a stale handle to a recycled identifier
+		bool valid(Entity entity) const {
+			uint32_t identifier = getIdentifier(entity);
+
+			// Dead slots hold a link of the free list, which never has the slot's own identifier
+			return identifier < entities.size() && entities[identifier] == entity;
+		}
+	};
+}
\ No newline at end of file
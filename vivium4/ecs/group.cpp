@@ -1,11 +1,29 @@
 #include "group.h"
+#include "component_array.h"
 
 namespace Vivium {
+	bool GroupMetadata::nestsInside(GroupMetadata const& outer) const
+	{
+		return ownedComponents.includes(outer.ownedComponents) && affectedComponents.includes(outer.affectedComponents);
+	}
+
+	uint64_t GroupMetadata::nestingDepth() const
+	{
+		return ownedComponents.count() * (ECS_COMPONENT_MAX + 1) + affectedComponents.count();
+	}
+
 	bool GroupMetadata::ownedID(uint8_t id) { return ownedComponents.test(id); }
 	bool GroupMetadata::containsID(uint8_t id) { return affectedComponents.test(id); }
 
+	bool GroupMetadata::containsEntity(Entity entity)
+	{
+		if (ownedPools.empty()) return false;
+
+		return ownedPools.front()->sparse.get(getIdentifier(entity)) < groupSize;
+	}
+
 	// Perfect match
-	bool GroupMetadata::ownsSignature(Signature const& signature) { return (signature & ownedComponents) == ownedComponents; }
+	bool GroupMetadata::ownsSignature(Signature const& signature) { return signature.includes(ownedComponents); }
 	// TODO: function should be inverted, suggests "signature" is subset of us, but tests for us being a subset of "signature"
-	bool GroupMetadata::containsSignature(Signature const& signature) { return (signature & affectedComponents) == affectedComponents; }
+	bool GroupMetadata::containsSignature(Signature const& signature) { return signature.includes(affectedComponents); }
 }
\ No newline at end of file
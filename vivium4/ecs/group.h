@@ -2,7 +2,11 @@
 
 #include "defines.h"
 
+#include <vector>
+
 namespace Vivium {
+	struct ComponentArray;
+
 	template <typename T>
 	struct Owned { using type = T; };
 	template <typename T>
@@ -32,12 +36,37 @@ namespace Vivium {
 	template <typename T>
 	concept OwnedTag = IsOwnedTag<T>::value;
 
+	// View filters, matching components changed/added since a tick
+	// Requires change tracking on the pool (Registry::trackChanges)
+	template <typename T>
+	struct Changed { using type = T; };
+	template <typename T>
+	struct Added { using type = T; };
+
+	template <typename T>
+	struct IsChangeFilter : std::false_type {};
+	template <typename T>
+	struct IsChangeFilter<Changed<T>> : std::true_type {};
+	template <typename T>
+	struct IsChangeFilter<Added<T>> : std::true_type {};
+
+	template <typename T>
+	struct IsAddedFilter : std::false_type {};
+	template <typename T>
+	struct IsAddedFilter<Added<T>> : std::true_type {};
+
+	template <typename T>
+	concept ChangeFilter = IsChangeFilter<T>::value;
+
 	struct GroupMetadata {
 		uint64_t groupSize;
 		Signature ownedComponents;
 		Signature partialComponents;
 		Signature affectedComponents; // ownedComponents | partialComponents
 
+		// Pools this group owns, empty if all components are partial
+		std::vector<ComponentArray*> ownedPools;
+
 		template <OwnershipTag... WrappedTypes>
 		void create() {
 			groupSize = 0;
@@ -57,8 +86,16 @@ namespace Vivium {
 			} (), ...);
 		}
 
+		// Groups sharing an owned pool must nest: the inner group owns and requires a superset of the outer
+		//	group's components, so its entities are a subset, kept at the front of the outer group's range
+		bool nestsInside(GroupMetadata const& outer) const;
+		// Larger for groups nested further in, outer groups always come before the groups nested inside them
+		uint64_t nestingDepth() const;
+
 		bool ownedID(uint8_t id);
 		bool containsID(uint8_t id);
+		// If the entity is within the owned range of this group
+		bool containsEntity(Entity entity);
 
 		// Perfect match
 		bool ownsSignature(Signature const& signature);
@@ -66,7 +103,7 @@ namespace Vivium {
 		bool containsSignature(Signature const& signature);
 
 		template <typename T>
-		bool contains() { return affectedComponents.test(TypeGenerator<T>::getIdentifier()); }
+		bool contains() { return affectedComponents.test(TypeGenerator::getIdentifier<T>()); }
 		template <typename... Ts>
 		bool any() { return (contains<Ts>() || ...); }
 		template <typename... Ts>
@@ -1,59 +1,291 @@
 #pragma once
 
-#include <array>
+#include "defines.h"
+#include "../serialiser/serialiser.h"
+
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <type_traits>
+#include <vector>
 
 namespace Vivium {
-	template <typename T, uint64_t pageSize, uint64_t capacity>
-	struct PagedArray {
-		static constexpr uint64_t pageCount = (capacity - 1) / pageSize + 1;
+	// Process-wide pool of pages of pageBytes bytes, shared by every PagedArray with that page size
+	// Pages are carved from blocks, and released pages are reused (by any array) before a new block is allocated
+	// A block goes back to the system once all of its pages are released, except for one spare block, so an
+	//	array crossing a page boundary back and forth doesn't allocate a block each time
+	template <uint64_t pageBytes>
+	struct PagePool {
+		static constexpr uint64_t blockPages = 16;
+		static constexpr uint32_t allPagesFree = (uint32_t(1) << blockPages) - 1;
 
-		T defaultValue;
-		std::array<T*, pageCount> pages;
+		std::mutex mutex;
+		// Start of every block, to the mask of its free pages
+		std::map<uint8_t*, uint32_t> blocks;
+		// Blocks with some pages free and some in use
+		std::set<uint8_t*> partialBlocks;
+		// Block with every page free, if any
+		uint8_t* spareBlock = nullptr;
 
-		PagedArray()
-		{
-			for (uint64_t i = 0; i < pageCount; i++) {
-				pages[i] = nullptr;
+		PagePool() = default;
+
+		~PagePool() {
+			for (auto const& [block, freePages] : blocks) {
+				::operator delete[](block, std::align_val_t(ECS_CACHE_LINE_SIZE));
 			}
 		}
 
-		PagedArray(T const& defaultValue) : PagedArray() { this->defaultValue = defaultValue; }
-		
+		PagePool(PagePool const&) = delete;
+		PagePool& operator=(PagePool const&) = delete;
+
+		uint8_t* allocate() {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			uint8_t* block;
+
+			// Filling partial blocks first leaves the others to empty out
+			if (!partialBlocks.empty()) {
+				block = *partialBlocks.begin();
+			}
+			else if (spareBlock != nullptr) {
+				block = spareBlock;
+				spareBlock = nullptr;
+			}
+			else {
+				block = static_cast<uint8_t*>(::operator new[](pageBytes * blockPages, std::align_val_t(ECS_CACHE_LINE_SIZE)));
+				blocks.emplace(block, allPagesFree);
+			}
+
+			uint32_t& freePages = blocks.find(block)->second;
+			uint64_t pageIndex = std::countr_zero(freePages);
+
+			freePages &= freePages - 1;
+
+			if (freePages == 0) partialBlocks.erase(block);
+			else partialBlocks.insert(block);
+
+			return block + pageIndex * pageBytes;
+		}
+
+		void release(uint8_t* page) {
+			std::lock_guard<std::mutex> lock(mutex);
+
+			// Last block starting at or before the page
+			auto found = std::prev(blocks.upper_bound(page));
+			uint8_t* block = found->first;
+
+			found->second |= uint32_t(1) << ((page - block) / pageBytes);
+
+			if (found->second != allPagesFree) {
+				partialBlocks.insert(block);
+
+				return;
+			}
+
+			partialBlocks.erase(block);
+
+			if (spareBlock == nullptr) {
+				spareBlock = block;
+
+				return;
+			}
+
+			::operator delete[](block, std::align_val_t(ECS_CACHE_LINE_SIZE));
+			blocks.erase(found);
+		}
+
+		// Every PagedArray constructor goes through here, so the pool is constructed before, and destroyed
+		//	after, any array in static storage
+		static PagePool& instance() {
+			static PagePool pool;
+
+			return pool;
+		}
+	};
+
+	// Read-only page filled with value, shared by all arrays of T with the same default value
+	template <typename T, uint64_t pageSize>
+	T* _sharedDefaultPage(T const& value) {
+		static std::mutex mutex;
+		static std::vector<T*> defaultPages;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		for (T* page : defaultPages) {
+			if (std::memcmp(page, &value, sizeof(T)) == 0) return page;
+		}
+
+		T* page = reinterpret_cast<T*>(PagePool<pageSize * sizeof(T)>::instance().allocate());
+		std::uninitialized_fill_n(page, pageSize, value);
+
+		defaultPages.push_back(page);
+
+		return page;
+	}
+
+	// Sparse array split into pages of pageSize elements
+	// Unwritten pages point at a shared page of defaultValue, a page is only taken from the PagePool on
+	//	the first write to it, and returned once all of its elements are back to defaultValue
+	// Writes go through set()/reset(), which count the non-default elements of each page
+	template <typename T, uint64_t pageSize>
+	struct PagedArray {
+		static_assert(std::is_trivially_copyable_v<T>, "Paged array elements are compared and copied bytewise");
+
+		static constexpr uint64_t pageBytes = pageSize * sizeof(T);
+
+		T defaultValue;
+		T* defaultPage;
+
+		// Grows up to the highest page written to
+		std::vector<T*> pages;
+		// Elements of each page not equal to defaultValue
+		std::vector<uint32_t> pageUsage;
+		uint64_t allocatedPages;
+
+		PagedArray() : PagedArray(T{}) {}
+
+		PagedArray(T const& defaultValue)
+			: defaultValue(defaultValue), defaultPage(_sharedDefaultPage<T, pageSize>(defaultValue)), allocatedPages(0)
+		{}
+
 		~PagedArray() {
+			clear();
+		}
+
+		PagedArray(PagedArray const&) = delete;
+		PagedArray& operator=(PagedArray const&) = delete;
+
+		// Releases all pages, so every index reads as the default value
+		void clear() {
 			for (T* page : pages) {
-				delete page;
+				if (page != defaultPage) {
+					PagePool<pageBytes>::instance().release(reinterpret_cast<uint8_t*>(page));
+				}
 			}
+
+			pages = {};
+			pageUsage = {};
+			allocatedPages = 0;
 		}
 
-		T& index(uint64_t i) {
+		bool _isDefault(T const& value) const {
+			return std::memcmp(&value, &defaultValue, sizeof(T)) == 0;
+		}
+
+		T* _getWritablePage(uint64_t pageIndex) {
+			if (pageIndex >= pages.size()) {
+				pages.resize(pageIndex + 1, defaultPage);
+				pageUsage.resize(pageIndex + 1, 0);
+			}
+
+			T*& page = pages[pageIndex];
+
+			if (page == defaultPage) {
+				page = reinterpret_cast<T*>(PagePool<pageBytes>::instance().allocate());
+				std::memcpy(page, defaultPage, pageBytes);
+
+				++allocatedPages;
+			}
+
+			return page;
+		}
+
+		void _releasePage(uint64_t pageIndex) {
+			PagePool<pageBytes>::instance().release(reinterpret_cast<uint8_t*>(pages[pageIndex]));
+			pages[pageIndex] = defaultPage;
+
+			--allocatedPages;
+		}
+
+		void set(uint64_t i, T const& value) {
 			uint64_t pageIndex = i / pageSize;
 			uint64_t indexInPage = i - pageIndex * pageSize;
 
-			T*& page = pages[pageIndex];
+			bool wasDefault = _isDefault(get(i));
+			bool isDefault = _isDefault(value);
 
-			if (page == nullptr) {
-				page = new T[pageSize];
+			if (wasDefault && isDefault) return;
 
-				for (uint64_t j = 0; j < pageSize; j++) {
-					page[j] = defaultValue;
-				}
+			_getWritablePage(pageIndex)[indexInPage] = value;
+
+			if (wasDefault) {
+				++pageUsage[pageIndex];
 			}
-			
-			return page[indexInPage];
+			else if (isDefault && --pageUsage[pageIndex] == 0) {
+				_releasePage(pageIndex);
+			}
+		}
+
+		void reset(uint64_t i) {
+			set(i, defaultValue);
 		}
 
-		T const& get(uint64_t i) {
+		// Mutable access to an element already given a non-default value through set()
+		// Doesn't update page usage, so the element must not be changed to or from the default value
+		T& index(uint64_t i) {
 			uint64_t pageIndex = i / pageSize;
 			uint64_t indexInPage = i - pageIndex * pageSize;
 
-			T*& page = pages[pageIndex];
+			return _getWritablePage(pageIndex)[indexInPage];
+		}
+
+		T const& get(uint64_t i) const {
+			uint64_t pageIndex = i / pageSize;
+			uint64_t indexInPage = i - pageIndex * pageSize;
 
-			if (page == nullptr) {
+			if (pageIndex >= pages.size()) {
 				return defaultValue;
 			}
 
-			return page[indexInPage];
+			return pages[pageIndex][indexInPage];
+		}
+
+		// Writes the page directory and every allocated page as raw blocks, default pages aren't stored
+		template <SerialiserInterface Interface>
+		void snapshot(Interface& store) const {
+			uint64_t pageCount = pages.size();
+
+			store.writeBytes(sizeof(uint64_t), &pageCount);
+			store.writeBytes(pageCount * sizeof(uint32_t), pageUsage.data());
+
+			for (uint64_t i = 0; i < pageCount; i++) {
+				if (pageUsage[i] != 0) {
+					store.writeBytes(pageBytes, pages[i]);
+				}
+			}
+		}
+
+		// Replaces the contents with those written by snapshot()
+		template <SerialiserInterface Interface>
+		void restore(Interface& store) {
+			clear();
+
+			uint64_t pageCount;
+			store.readBytes(sizeof(uint64_t), &pageCount);
+
+			pages.resize(pageCount, defaultPage);
+			pageUsage.resize(pageCount);
+			store.readBytes(pageCount * sizeof(uint32_t), pageUsage.data());
+
+			for (uint64_t i = 0; i < pageCount; i++) {
+				if (pageUsage[i] != 0) {
+					pages[i] = reinterpret_cast<T*>(PagePool<pageBytes>::instance().allocate());
+					store.readBytes(pageBytes, pages[i]);
+
+					++allocatedPages;
+				}
+			}
+		}
+
+		// Bytes of pages owned by this array, and of the page directory
+		uint64_t memoryUsage() const {
+			return allocatedPages * pageBytes + pages.capacity() * sizeof(T*) + pageUsage.capacity() * sizeof(uint32_t);
 		}
 	};
 }
\ No newline at end of file
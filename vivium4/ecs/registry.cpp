@@ -1,11 +1,15 @@
 #include "registry.h"
 
+#include <algorithm>
+#include <bit>
+
 namespace Vivium {
 	Registry::Registry()
-		: signatures(Signature{})
+		: signatures(Signature{}), tick(1)
 	{
 		for (uint64_t i = 0; i < componentPools.size(); i++) {
 			componentPools[i] = nullptr;
+			componentGroups[i] = 0;
 		}
 	}
 
@@ -14,94 +18,376 @@ namespace Vivium {
 		for (ComponentArray* pool : componentPools) {
 			delete pool;
 		}
+
+		for (GroupMetadata* group : groups) {
+			delete group;
+		}
 	}
 
 	void Registry::free(Entity entity)
 	{
+		if (!valid(entity)) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Freed invalid entity {}", entity);
+
+			return;
+		}
+
+		// Before any pool changes, so listeners see the whole entity
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr || pool->destroySignal.empty()) continue;
+			if (!pool->contains(entity)) continue;
+
+			pool->destroySignal.publish(*this, entity);
+		}
+
+		Signature const& signature = signatures.get(getIdentifier(entity));
+
+		// Leave groups first, so freeing from pools doesn't break group packing
+		GroupMask groupMask = 0;
+
+		for (uint64_t i = 0; i < groups.size(); i++) {
+			groupMask |= GroupMask(1) << i;
+		}
+
+		removeEntityFromOwningGroup(entity, signature, groupMask);
+
 		for (ComponentArray* pool : componentPools) {
 			if (pool == nullptr) continue;
 			if (!pool->contains(entity)) continue;
 
 			pool->free(entity);
-			signatures.index(getIdentifier(entity)).set(pool->manager.componentIDFunction(), 0);
 		}
 
-		++availableEntities;
-		// Build implicit list
-		Entity& destroyedEntity = entities[getIdentifier(entity)];
-		// Increment version number
-		destroyedEntity += (1 << 20);
-		std::swap(destroyedEntity, nextEntity);
+		signatures.reset(getIdentifier(entity));
+
+		entityAllocator.free(entity);
 	}
 
 	void Registry::clear()
 	{
-		// TODO: current implementation doesn't take into account version numbers
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr || pool->destroySignal.empty()) continue;
+
+			for (uint64_t i = 0; i < pool->size; i++) {
+				pool->destroySignal.publish(*this, pool->entities[i]);
+			}
+		}
+
 		// Clear all component pools
 		for (ComponentArray* pool : componentPools) {
 			if (pool == nullptr) continue;
 
 			pool->clear();
 		}
-		// Clear all entities and signatures
-		availableEntities = 0;
-		nextEntity = ECS_ENTITY_MAX;
-
-		entities = {};
+		// Free all entities, bumping their versions, and clear signatures
+		entityAllocator.clear();
 
-		signatures = { ECS_ENTITY_MAX };
+		signatures.clear();
 
 		for (GroupMetadata* group : groups) {
 			delete group;
 		}
 
 		groups = {};
-
-		nextLargestEntity = 0;
+		groupOrder = {};
+		componentGroups.fill(0);
 	}
 
 	Entity Registry::create()
 	{
-		if (availableEntities > 0) {
-			Entity nextNext = entities[getIdentifier(nextEntity)];
-			std::swap(nextNext, nextEntity);
-			--availableEntities;
+		return entityAllocator.create();
+	}
+
+	bool Registry::valid(Entity entity) const
+	{
+		return entityAllocator.valid(entity);
+	}
 
-			return nextNext;
+	void Registry::createMany(uint64_t count, std::span<Entity> out)
+	{
+		entityAllocator.createMany(count, out);
+	}
+
+	uint32_t Registry::advanceTick()
+	{
+		return ++tick;
+	}
+
+	void Registry::snapshot(Serialiser& store) const
+	{
+		uint32_t poolCount = 0;
+
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr) continue;
+
+			if (pool->manager.snapshotFunction == nullptr) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Component {} isn't trivially copyable, and has no serialise hooks",
+					pool->manager.componentIDFunction());
+
+				return;
+			}
+
+			++poolCount;
+		}
+
+		// Header, validated by restore before anything is overwritten
+		uint64_t entityBytes = sizeof(Entity);
+		uint64_t groupCount = groups.size();
+
+		store.writeBytes(sizeof(uint64_t), &entityBytes);
+		store.writeBytes(sizeof(uint32_t), &tick);
+		store.writeBytes(sizeof(uint64_t), &groupCount);
+
+		for (GroupMetadata* group : groups) {
+			store.writeBytes(sizeof(Signature), &group->ownedComponents);
+			store.writeBytes(sizeof(Signature), &group->partialComponents);
+			store.writeBytes(sizeof(uint64_t), &group->groupSize);
 		}
 
-		entities.push_back(nextLargestEntity);
-		return nextLargestEntity++;
+		store.writeBytes(sizeof(uint32_t), &poolCount);
+
+		for (uint32_t id = 0; id < componentPools.size(); id++) {
+			if (componentPools[id] == nullptr) continue;
+
+			store.writeBytes(sizeof(uint32_t), &id);
+			store.writeBytes(sizeof(uint64_t), &componentPools[id]->manager.typeSize);
+		}
+
+		entityAllocator.snapshot(store);
+		signatures.snapshot(store);
+
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr) continue;
+
+			pool->snapshot(store);
+		}
 	}
-	
-	void Registry::moveEntityIntoOwningGroup(Entity entity, Signature const& signature)
+
+	void Registry::restore(Serialiser& store)
+	{
+		uint64_t entityBytes;
+		uint32_t snapshotTick;
+		uint64_t groupCount;
+
+		store.readBytes(sizeof(uint64_t), &entityBytes);
+		store.readBytes(sizeof(uint32_t), &snapshotTick);
+		store.readBytes(sizeof(uint64_t), &groupCount);
+
+		if (entityBytes != sizeof(Entity)) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Snapshot has {} byte entities, expected {}", entityBytes, sizeof(Entity));
+
+			return;
+		}
+
+		if (groupCount != groups.size()) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Snapshot has {} groups, registry has {}", groupCount, groups.size());
+
+			return;
+		}
+
+		std::vector<uint64_t> groupSizes(groupCount);
+
+		for (uint64_t i = 0; i < groupCount; i++) {
+			Signature ownedComponents;
+			Signature partialComponents;
+
+			store.readBytes(sizeof(Signature), &ownedComponents);
+			store.readBytes(sizeof(Signature), &partialComponents);
+			store.readBytes(sizeof(uint64_t), &groupSizes[i]);
+
+			if (ownedComponents != groups[i]->ownedComponents || partialComponents != groups[i]->partialComponents) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Snapshot group {} doesn't match registry group", i);
+
+				return;
+			}
+		}
+
+		uint32_t poolCount;
+		store.readBytes(sizeof(uint32_t), &poolCount);
+
+		std::vector<ComponentArray*> restoredPools(poolCount);
+
+		for (uint32_t i = 0; i < poolCount; i++) {
+			uint32_t id;
+			uint64_t typeSize;
+
+			store.readBytes(sizeof(uint32_t), &id);
+			store.readBytes(sizeof(uint64_t), &typeSize);
+
+			if (id >= componentPools.size() || componentPools[id] == nullptr || componentPools[id]->manager.typeSize != typeSize) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Component {} must be registered before restoring", id);
+
+				return;
+			}
+
+			if (componentPools[id]->manager.restoreFunction == nullptr) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Component {} isn't trivially copyable, and has no serialise hooks", id);
+
+				return;
+			}
+
+			restoredPools[i] = componentPools[id];
+		}
+
+		tick = snapshotTick;
+
+		entityAllocator.restore(store);
+		signatures.restore(store);
+
+		// Pools missing from the snapshot had no components
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr) continue;
+			if (std::find(restoredPools.begin(), restoredPools.end(), pool) != restoredPools.end()) continue;
+
+			pool->_removeAll();
+		}
+
+		for (ComponentArray* pool : restoredPools) {
+			pool->restore(store);
+		}
+
+		for (uint64_t i = 0; i < groupCount; i++) {
+			groups[i]->groupSize = groupSizes[i];
+		}
+	}
+
+	void Registry::flushSignals()
 	{
-		std::vector<GroupMetadata*> affectedGroups;
+		for (ComponentArray* pool : componentPools) {
+			if (pool == nullptr) continue;
 
-		bool movedEntity = false;
+			pool->constructSignal.flush(*this);
+			pool->destroySignal.flush(*this);
+			pool->updateSignal.flush(*this);
+		}
+	}
+
+	void Registry::logMemoryUsage()
+	{
+		uint64_t totalSparse = 0;
+		uint64_t totalDense = 0;
 
 		for (ComponentArray* pool : componentPools) {
 			if (pool == nullptr) continue;
-			if (!pool->isOwned()) continue;
-			if (!pool->owner->containsSignature(signature)) continue;
 
-			GroupMetadata* relevantGroup = pool->owner;
+			uint64_t sparseBytes = pool->sparseMemoryUsage();
+			uint64_t denseBytes = pool->denseMemoryUsage();
+
+			VIVIUM_LOG(LogSeverity::DEBUG, "Component {}: {} entities, sparse {} bytes ({} pages), dense {} bytes",
+				pool->manager.componentIDFunction(), pool->size, sparseBytes, pool->sparse.allocatedPages, denseBytes);
 
-			// Not already in our affected groups
-			if (std::find(affectedGroups.begin(), affectedGroups.end(), relevantGroup) == affectedGroups.end()) {
-				affectedGroups.push_back(relevantGroup);
+			totalSparse += sparseBytes;
+			totalDense += denseBytes;
+		}
+
+		VIVIUM_LOG(LogSeverity::DEBUG, "Signatures {} bytes, pools sparse {} bytes, dense {} bytes",
+			signatures.memoryUsage(), totalSparse, totalDense);
+	}
+	
+	void Registry::moveEntityIntoOwningGroup(Entity entity, Signature const& signature, GroupMask groupMask)
+	{
+		// Outer groups first, so the entity is already in the range an inner group is carved from
+		for (uint32_t groupIndex : groupOrder) {
+			if ((groupMask & (GroupMask(1) << groupIndex)) == 0) continue;
+
+			GroupMetadata* group = groups[groupIndex];
+
+			if (!group->containsSignature(signature)) continue;
+			if (group->containsEntity(entity)) continue;
+
+			for (ComponentArray* pool : group->ownedPools) {
+				pool->swap(entity, pool->entities[group->groupSize]);
 			}
 
-			Entity const& replacementEntity = pool->entities[pool->owner->groupSize];
-			pool->swap(entity, replacementEntity);
+			++group->groupSize;
+		}
+	}
+
+	void Registry::removeEntityFromOwningGroup(Entity entity, Signature const& signature, GroupMask groupMask)
+	{
+		// Inner groups first, so the entity leaves the inner range before moving within the outer range
+		for (uint64_t i = groupOrder.size(); i-- > 0;) {
+			uint32_t groupIndex = groupOrder[i];
+
+			if ((groupMask & (GroupMask(1) << groupIndex)) == 0) continue;
+
+			GroupMetadata* group = groups[groupIndex];
+
+			if (!group->containsSignature(signature)) continue;
+			if (!group->containsEntity(entity)) continue;
+
+			--group->groupSize;
+
+			for (ComponentArray* pool : group->ownedPools) {
+				pool->swap(entity, pool->entities[group->groupSize]);
+			}
+		}
+	}
+
+	void Registry::_rebuildGroupOrder()
+	{
+		groupOrder.resize(groups.size());
+
+		for (uint32_t i = 0; i < groupOrder.size(); i++) {
+			groupOrder[i] = i;
+		}
+
+		std::stable_sort(groupOrder.begin(), groupOrder.end(), [this](uint32_t a, uint32_t b) {
+			return groups[a]->nestingDepth() < groups[b]->nestingDepth();
+		});
+	}
+
+	void Registry::_destroyGroup(GroupMetadata* group)
+	{
+		auto found = std::find(groups.begin(), groups.end(), group);
 
-			movedEntity = true;
+		if (found == groups.end()) {
+			VIVIUM_LOG(LogSeverity::FATAL, "Destroyed view of an unknown group");
+
+			return;
+		}
+
+		uint64_t groupIndex = found - groups.begin();
+
+		for (ComponentArray* pool : group->ownedPools) {
+			pool->owners.erase(std::find(pool->owners.begin(), pool->owners.end(), group));
+		}
+
+		// Groups after this one move down an index, so do their bits
+		GroupMask lowerBits = (GroupMask(1) << groupIndex) - 1;
+
+		for (GroupMask& mask : componentGroups) {
+			mask = (mask & lowerBits) | ((mask >> 1) & ~lowerBits);
 		}
 
-		// Increment group sizes
-		if (movedEntity) {
-			for (GroupMetadata* group : affectedGroups) {
-				++group->groupSize;
+		groups.erase(found);
+		_rebuildGroupOrder();
+
+		delete group;
+	}
+
+	void Registry::_partitionIntoGroup(GroupMetadata* group, std::span<const Entity> newEntities)
+	{
+		for (Entity entity : newEntities) {
+			if (!group->containsSignature(signatures.get(getIdentifier(entity)))) continue;
+			if (group->containsEntity(entity)) continue;
+
+			for (ComponentArray* pool : group->ownedPools) {
+				pool->swap(entity, pool->entities[group->groupSize]);
+			}
+
+			++group->groupSize;
+		}
+	}
+	void Registry::_partitionOutOfGroup(GroupMetadata* group, std::span<const Entity> oldEntities)
+	{
+		for (Entity entity : oldEntities) {
+			if (!group->containsEntity(entity)) continue;
+
+			--group->groupSize;
+
+			for (ComponentArray* pool : group->ownedPools) {
+				pool->swap(entity, pool->entities[group->groupSize]);
 			}
 		}
 	}
@@ -3,132 +3,113 @@
 #include "paged_array.h"
 #include "defines.h"
 #include "component_array.h"
+#include "entity_allocator.h"
+#include "context.h"
 
 #include "../error/log.h"
+#include "../system/job_system.h"
 
-namespace Vivium {
-	struct Registry;
+#include <bit>
+#include <limits>
+#include <span>
+#include <tuple>
 
+namespace Vivium {
 	template <typename T, OwnershipTag... Components>
-	constexpr inline bool _isOwnedType = (std::is_same_v<T, typename Components::type> || ...);
+	constexpr inline bool _isOwnedType = ((std::is_same_v<T, typename Components::type> && IsOwnedTag<Components>::value) || ...);
 
-	// https://internalpointers.com/post/writing-custom-iterators-modern-cpp
 	template <OwnershipTag... Components>
-	struct ViewElement {
-		uint64_t index;
-		Entity entity;
-
-		Registry* registry;
-
-		template <typename T>
-		T& get() {
-			if constexpr (_isOwnedType<T, Components...>) {
-				return registry->componentPools[TypeGenerator::getIdentifier<T>()]->_getIndex<T>(index);
-			}
-			else {
-				return registry->getComponent<T>(entity);
-			}
-		}
-	};
-
+	struct ViewElement;
 	template <OwnershipTag... WrappedTypes>
-	struct View {
-		Registry* registry;
-		Entity* ownedEntityArray;
-		GroupMetadata* groupMetadata;
-
-		struct ViewIterator {
-			using iterator_category = std::forward_iterator_tag;
-			using difference_type = void;
-			using value_type = ViewElement<WrappedTypes...>;
-			using pointer = value_type*;
-			using reference = value_type&;
-
-			Registry* registry;
-			Entity* ownedEntityArray;
-			GroupMetadata* groupMetadata;
-
-			value_type current;
-
-			ViewIterator(Registry* registry, Entity* ownedEntityArray, GroupMetadata* groupMetadata, uint64_t startIndex, Entity entity)
-				: registry(registry), ownedEntityArray(ownedEntityArray), groupMetadata(groupMetadata)
-			{
-				current.index = startIndex;
-				current.entity = entity;
-				current.registry = registry;
-			}
-
-			reference operator*() { return current; }
-			pointer operator->() { return &current; }
-
-			ViewIterator& operator++() {
-				current.entity = ownedEntityArray[current.index++];
-
-				// All partially owned
-				// TODO: determine at compile-time
-				if (!groupMetadata->ownedComponents.any()) {
-					while (groupMetadata->containsSignature(registry->signatures.get(getIdentifier(current.entity))) && current.index < groupMetadata->groupSize) {
-						current.entity = ownedEntityArray[current.index++];
-					}
-				}
-
-				return *this;
-			}
-			ViewIterator operator++(int) { ViewIterator tmp = *this; ++(*this); return tmp; }
-
-			bool operator==(ViewIterator const& other) { return current.index == other.current.index; }
-			bool operator!=(ViewIterator const& other) { return current.index != other.current.index; }
-		};
-
-		ViewIterator begin() { return ViewIterator(registry, ownedEntityArray, groupMetadata, 0, ownedEntityArray[0]); }
-		ViewIterator end() { return ViewIterator(registry, ownedEntityArray, groupMetadata, groupMetadata->groupSize, ECS_ENTITY_DEAD); }
-	};
+	struct View;
 
 	struct Registry {
-		PagedArray<Signature, ECS_PAGE_SIZE, ECS_ENTITY_MAX> signatures;
+		PagedArray<Signature, ECS_PAGE_SIZE> signatures;
 		// TODO: test allocating 64 components
 		std::array<ComponentArray*, ECS_COMPONENT_MAX> componentPools;
 
-		// Next to be recycled
-		Entity nextEntity = ECS_ENTITY_MAX;
-		// Next new available
-		Entity nextLargestEntity = 0;
-		uint32_t availableEntities = 0;
-
-		// All alive/dead entities
-		std::vector<Entity> entities;
+		EntityAllocator entityAllocator;
 
+		// Bit i is set if groups[i] includes the component
+		std::array<GroupMask, ECS_COMPONENT_MAX> componentGroups;
 		std::vector<GroupMetadata*> groups;
+		// Indices into groups, outer groups before the groups nested inside them
+		// Entities enter groups in this order and leave in reverse, so nested ranges stay packed
+		std::vector<uint32_t> groupOrder;
+
+		// Stamped onto tracked components when added or changed
+		uint32_t tick;
+
+		// Singletons, not tied to any entity
+		Context context;
 
 		Registry();
 		~Registry();
 
 		void free(Entity entity);
+		// Frees all entities, handles from before the clear stay invalid
 		void clear();
 		Entity create();
+		// If entity is alive, false for handles to freed (possibly recycled) entities
+		bool valid(Entity entity) const;
+		// Creates count entities into out, recycling freed entities first
+		void createMany(uint64_t count, std::span<Entity> out);
 
-		void moveEntityIntoOwningGroup(Entity entity, Signature const& signature);
+		// Registry-wide singleton of T (e.g. frame time, input state), default constructed on first access
+		// Not affected by clear(), and not included in snapshots
+		template <typename T>
+		T& ctx() {
+			return context.get<T>();
+		}
+
+		// Starts a new tick, returning it
+		// A system consuming changes passes the tick returned after its previous pass to View::each<Changed<T>>,
+		//	or 0 to match everything
+		uint32_t advanceTick();
+
+		// Logs sparse and dense bytes of every pool, and of the signature array
+		void logMemoryUsage();
+
+		// Writes all entities, signatures and components
+		// Pools are streamed as raw blocks, components that aren't trivially copyable need serialiseWrite/serialiseRead hooks
+		void snapshot(Serialiser& store) const;
+		// Replaces all entities, signatures and components with those written by snapshot()
+		// Component ids are assigned at runtime, so the snapshot must come from the same process, and
+		//	every pool in it must already be registered, with the same groups created in the same order
+		void restore(Serialiser& store);
+
+		// Moves entity into the owned range of each group in groupMask it now matches
+		void moveEntityIntoOwningGroup(Entity entity, Signature const& signature, GroupMask groupMask);
+		// Moves entity out of the owned range of each group in groupMask it currently belongs to
+		void removeEntityFromOwningGroup(Entity entity, Signature const& signature, GroupMask groupMask);
+		// Moves all given entities that now match the group into the group, in a single pass
+		void _partitionIntoGroup(GroupMetadata* group, std::span<const Entity> newEntities);
+		// Moves all given entities out of the group's owned range, in a single pass
+		void _partitionOutOfGroup(GroupMetadata* group, std::span<const Entity> oldEntities);
+		void _rebuildGroupOrder();
+		// Releases ownership of the group's pools, and forgets the group
+		void _destroyGroup(GroupMetadata* group);
 
 		template <ValidComponent T>
-		ComponentArray*& _getPoolOrCreate() {
+		TypedComponentArray<T>* _getPoolOrCreate() {
 			uint8_t componentID = TypeGenerator::getIdentifier<T>();
 			
 			ComponentArray*& arr = componentPools[componentID];
 			
 			if (arr == nullptr) { registerComponent<T>(); }
 
-			return arr;
+			return static_cast<TypedComponentArray<T>*>(arr);
 		}
 
+		// Records added/changed ticks for T, for Changed<T> and Added<T> filters
 		template <ValidComponent T>
-		void resizePool(uint64_t newCapacity) {
-			ComponentArray* arr = _getPoolOrCreate<T>();
-
-			if (arr == nullptr) {
-				registerComponent<T>();
-			}
+		void trackChanges() {
+			_getPoolOrCreate<T>()->enableTracking(tick);
+		}
 
-			arr->resize(newCapacity);
+		template <ValidComponent T>
+		void resizePool(uint64_t newCapacity) {
+			_getPoolOrCreate<T>()->resize(newCapacity);
 		}
 
 		template <ValidComponent T>
@@ -143,123 +124,665 @@ namespace Vivium {
 				return;
 			}
 
-			arr = new ComponentArray();
-			arr->manager = defaultComponentManager<T>();
-			arr->resize(0);
+			arr = new TypedComponentArray<T>();
 		}
 
 		template <ValidComponent T>
 		void addComponent(Entity entity, T&& component) {
+			emplace<T>(entity, std::move(component));
+		}
+
+		// Adds a T constructed from arguments directly in its pool, without a temporary
+		// The reference is invalidated by any structural change to the registry
+		template <ValidComponent T, typename... Args>
+		T& emplace(Entity entity, Args&&... arguments) {
 			uint8_t componentID = TypeGenerator::getIdentifier<T>();
-			ComponentArray* arr = _getPoolOrCreate<T>();
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			// Nothing was constructed, so nothing is stamped, moved or published
+			if (arr->contains(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity already had component");
 
-			arr->push<T>(entity, std::forward<T>(component));
+				return arr->get(entity);
+			}
+
+			arr->emplace(entity, std::forward<Args>(arguments)...);
+			arr->_stampAdded(arr->size - 1, arr->size, tick);
 
-			Signature& signature = signatures.index(getIdentifier(entity));
+			Signature signature = signatures.get(getIdentifier(entity));
 			signature.set(componentID);
+			signatures.set(getIdentifier(entity), signature);
+
+			moveEntityIntoOwningGroup(entity, signature, componentGroups[componentID]);
+
+			arr->constructSignal.publish(*this, entity);
+
+			// Joining a group may have moved the component
+			return arr->get(entity);
+		}
+
+		// Replaces the existing T of entity with one constructed from arguments in the same slot
+		// Stamps the component as changed, and publishes onUpdate
+		template <ValidComponent T, typename... Args>
+		T& replace(Entity entity, Args&&... arguments) {
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			// There's no component to return, so unlike remove this can't carry on
+			if (!valid(entity) || !arr->contains(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Replaced component of invalid entity {}, or one without it", entity);
 
-			if (arr->owner != nullptr && arr->owner->ownsSignature(signature)) {
-				moveEntityIntoOwningGroup(entity, signature);
+				std::terminate();
 			}
+
+			T& component = arr->replace(entity, std::forward<Args>(arguments)...);
+
+			arr->_stampChanged(arr->sparse.get(getIdentifier(entity)), tick);
+			arr->updateSignal.publish(*this, entity);
+
+			return component;
+		}
+
+		// Write access to the existing T of entity, or one emplaced from arguments if it had none
+		template <ValidComponent T, typename... Args>
+		T& getOrEmplace(Entity entity, Args&&... arguments) {
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			if (arr->contains(entity)) {
+				return getComponent<T>(entity);
+			}
+
+			return emplace<T>(entity, std::forward<Args>(arguments)...);
 		}
 
+		// Adds components[i] to targetEntities[i], reserving the pool once and partitioning
+		//	any owning group once for the whole batch
 		template <ValidComponent T>
-		void removeComponent(Entity entity) {
+		void addComponents(std::span<const Entity> targetEntities, std::span<T> components) {
+			if (targetEntities.size() != components.size()) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Entity count didn't match component count");
+
+				return;
+			}
+
+			if (targetEntities.empty()) return;
+
 			uint8_t componentID = TypeGenerator::getIdentifier<T>();
-			ComponentArray* arr = _getPoolOrCreate<T>();
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			uint64_t oldSize = arr->size;
 
-			Signature& signature = signatures.index(getIdentifier(entity));
+			arr->pushMany(targetEntities, components);
+			arr->_stampAdded(oldSize, arr->size, tick);
 
-			GroupMetadata* relevantGroup = nullptr;
+			// Entities that already had T were skipped, continue with those inserted, copied
+			//	since partitioning reorders the pool
+			std::vector<Entity> insertedEntities;
 
-			for (ComponentArray* pool : componentPools) {
-				if (pool == nullptr) continue;
-				if (pool->owner == nullptr) continue;
-				if (!pool->owner->ownsSignature(signature)) continue;
+			if (arr->size - oldSize != targetEntities.size()) {
+				insertedEntities.assign(arr->entities + oldSize, arr->entities + arr->size);
+				targetEntities = insertedEntities;
+			}
 
-				relevantGroup = pool->owner;
+			for (Entity entity : targetEntities) {
+				Signature signature = signatures.get(getIdentifier(entity));
+				signature.set(componentID);
+				signatures.set(getIdentifier(entity), signature);
+			}
+
+			GroupMask groupMask = componentGroups[componentID];
+
+			for (uint32_t groupIndex : groupOrder) {
+				if ((groupMask & (GroupMask(1) << groupIndex)) == 0) continue;
+
+				_partitionIntoGroup(groups[groupIndex], targetEntities);
+			}
 
-				Entity& lastEntity = pool->entities[pool->owner->groupSize - 1];
-				pool->swap(lastEntity, entity);
+			if (!arr->constructSignal.empty()) {
+				for (Entity entity : targetEntities) {
+					arr->constructSignal.publish(*this, entity);
+				}
+			}
+		}
+
+		template <ValidComponent T>
+		void removeComponent(Entity entity) {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			// A stale handle may share its index with a live entity, which must keep its component
+			if (!valid(entity) || !arr->contains(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Removed component from invalid entity {}, or one without it", entity);
+
+				return;
 			}
 
+			// Listeners can still read the component
+			arr->destroySignal.publish(*this, entity);
+
+			Signature signature = signatures.get(getIdentifier(entity));
+
+			removeEntityFromOwningGroup(entity, signature, componentGroups[componentID]);
+
 			arr->free(entity);
-			signature.set(componentID, 0);
-			
-			if (relevantGroup) relevantGroup->groupSize--;
+
+			signature.reset(componentID);
+			signatures.set(getIdentifier(entity), signature);
+		}
+
+		// Removes T from every entity in targetEntities that has it, moving them out of each owning
+		//	group in a single pass per group
+		template <ValidComponent T>
+		void removeComponents(std::span<const Entity> targetEntities) {
+			uint8_t componentID = TypeGenerator::getIdentifier<T>();
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			std::vector<Entity> removedEntities;
+			removedEntities.reserve(targetEntities.size());
+
+			for (Entity entity : targetEntities) {
+				Signature signature = signatures.get(getIdentifier(entity));
+
+				// Several jobs may remove the same component, only remove it once
+				if (!arr->contains(entity) || !signature.test(componentID)) continue;
+
+				// Listeners can still read the component
+				arr->destroySignal.publish(*this, entity);
+
+				signature.reset(componentID);
+				signatures.set(getIdentifier(entity), signature);
+
+				removedEntities.push_back(entity);
+			}
+
+			GroupMask groupMask = componentGroups[componentID];
+
+			// Inner groups first, as in removeEntityFromOwningGroup
+			for (uint64_t i = groupOrder.size(); i-- > 0;) {
+				uint32_t groupIndex = groupOrder[i];
+
+				if ((groupMask & (GroupMask(1) << groupIndex)) == 0) continue;
+
+				_partitionOutOfGroup(groups[groupIndex], removedEntities);
+			}
+
+			for (Entity entity : removedEntities) {
+				arr->free(entity);
+			}
 		}
 
+		// Sorts the components of T by compare(T const&, T const&)
+		// If T is owned by groups, each group's range is sorted by T in every pool of that group, and the
+		//	remainder of T's pool is sorted separately
+		template <ValidComponent T, typename Compare>
+		void sort(Compare compare, SortMode mode = SortMode::FULL) {
+			static_assert(!std::is_empty_v<T>, "Tags have no storage to sort by");
+
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+			uint64_t begin = 0;
+
+			if (arr->isOwned()) {
+				begin = _sortGroupRange(arr->owners, arr->owners.back(), arr->data(), compare, mode);
+			}
+
+			ComponentArray* pool = arr;
+			_sortPools(std::span<ComponentArray* const>(&pool, 1), arr->data(), begin, arr->size, compare, mode);
+		}
+
+		// Sorts the range of group by keys, where owners are the groups nested in one pool, innermost first
+		// The range of each group nested in group is sorted on its own, so it stays at the front
+		// Returns the end of group's range
+		template <typename Key, typename Compare>
+		uint64_t _sortGroupRange(std::span<GroupMetadata* const> owners, GroupMetadata* group, Key const* keys, Compare& compare, SortMode mode) {
+			uint64_t begin = 0;
+
+			for (GroupMetadata* owner : owners) {
+				_sortPools(owner->ownedPools, keys, begin, owner->groupSize, compare, mode);
+				begin = owner->groupSize;
+
+				if (owner == group) break;
+			}
+
+			return begin;
+		}
+
+		// Sorts range [begin, end) of every pool by keys[begin, end), applying the same permutation to each
+		template <typename Key, typename Compare>
+		void _sortPools(std::span<ComponentArray* const> pools, Key const* keys, uint64_t begin, uint64_t end, Compare& compare, SortMode mode) {
+			if (end - begin < 2) return;
+
+			std::vector<uint32_t> order = _sortOrder(keys + begin, end - begin, compare, mode);
+
+			for (ComponentArray* pool : pools) {
+				pool->permute(begin, order);
+			}
+		}
+
+		// Write access, stamps the component as changed if T is tracked
 		template <ValidComponent T>
 		T& getComponent(Entity entity) {
-			return _getPoolOrCreate<T>()->get<T>(entity);
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+			T& component = arr->get(entity);
+
+			arr->_stampChanged(arr->sparse.get(getIdentifier(entity)), tick);
+
+			return component;
 		}
 
+		template <ValidComponent T>
+		T const& readComponent(Entity entity) {
+			return _getPoolOrCreate<T>()->get(entity);
+		}
+
+		// Stamps the component as changed and publishes onUpdate, for writes that didn't go through getComponent
+		//	(e.g. span iteration)
+		template <ValidComponent T>
+		void markDirty(Entity entity) {
+			TypedComponentArray<T>* arr = _getPoolOrCreate<T>();
+
+			if (!valid(entity) || !arr->contains(entity)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Marked component of invalid entity {} dirty, or one without it", entity);
+
+				return;
+			}
+
+			arr->_stampChanged(arr->sparse.get(getIdentifier(entity)), tick);
+			arr->updateSignal.publish(*this, entity);
+		}
+
+		// Listeners called with (Registry&, Entity) after a T is added
+		template <ValidComponent T>
+		ComponentSignal& onConstruct() {
+			return _getPoolOrCreate<T>()->constructSignal;
+		}
+
+		// Listeners called with (Registry&, Entity) before a T is removed, or its entity freed
+		template <ValidComponent T>
+		ComponentSignal& onDestroy() {
+			return _getPoolOrCreate<T>()->destroySignal;
+		}
+
+		// Listeners called with (Registry&, Entity) when a T is marked dirty
+		template <ValidComponent T>
+		ComponentSignal& onUpdate() {
+			return _getPoolOrCreate<T>()->updateSignal;
+		}
+
+		// Delivers the pending events of every deferred signal
+		void flushSignals();
+
+		// Owned components may already be owned by other groups, as long as the groups nest
+		//	(see GroupMetadata::nestsInside)
+		// Views with only partial components aren't groups, they keep no metadata and take no group slot
 		template <OwnershipTag... Components>
 		View<Components...> createView() {
-			GroupMetadata* metadata = new GroupMetadata;
-			groups.push_back(metadata);
+			if constexpr (View<Components...>::_isPartial) {
+				(_getPoolOrCreate<typename Components::type>(), ...);
+
+				// Iterating array is picked when iteration begins
+				return View<Components...> { this, nullptr, nullptr };
+			}
+			else {
+				return _createGroupView<Components...>();
+			}
+		}
+
+		template <OwnershipTag... Components>
+		View<Components...> _createGroupView() {
+			// Group bits are a GroupMask, so a group past the limit has no bit to take
+			if (groups.size() >= ECS_GROUP_MAX) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Couldn't create group, exceeded maximum group count");
+
+				std::terminate();
+			}
 
+			GroupMetadata* metadata = new GroupMetadata;
 			metadata->create<Components...>();
 
+			for (GroupMetadata* other : groups) {
+				if (!other->ownedComponents.intersects(metadata->ownedComponents)) continue;
+
+				if (!metadata->nestsInside(*other) && !other->nestsInside(*metadata)) {
+					VIVIUM_LOG(LogSeverity::FATAL, "Couldn't create group, owns components of a group it doesn't nest with");
+				}
+			}
+
+			GroupMask groupBit = GroupMask(1) << groups.size();
+			groups.push_back(metadata);
+			_rebuildGroupOrder();
+
 			ComponentArray* iteratingArray = nullptr;
 			uint64_t iteratingSize = std::numeric_limits<uint64_t>::max();
 
-			bool ownedGroup = false;
+			([&iteratingArray, &iteratingSize, metadata, groupBit, this] {
+				using T = typename Components::type;
 
-			([&ownedGroup, &iteratingArray, &iteratingSize, metadata, this] {
-				if constexpr (IsOwnedTag<Components>::value) {
-					ownedGroup = true;
+				ComponentArray* pool = this->_getPoolOrCreate<T>();
+				this->componentGroups[TypeGenerator::getIdentifier<T>()] |= groupBit;
 
-					uint32_t id = TypeGenerator::getIdentifier<Components::type>();
-					ComponentArray* pool = this->componentPools[id];
+				if constexpr (IsOwnedTag<Components>::value) {
+					// Nested groups share the pool, innermost first
+					pool->owners.push_back(metadata);
+					std::sort(pool->owners.begin(), pool->owners.end(), [](GroupMetadata* a, GroupMetadata* b) {
+						return a->nestingDepth() > b->nestingDepth();
+					});
 
-					if (pool == nullptr) return;
+					metadata->ownedPools.push_back(pool);
 
+					// Iterate smallest owned pool
+					// The owned range of any group nested in this one is at the front of every owned pool, so it's
+					//	partitioned first and stays in place
 					if (pool->size < iteratingSize) {
 						iteratingSize = pool->size;
 						iteratingArray = pool;
 					}
+				}
+			} (), ...);
+
+			for (uint64_t i = 0; i < iteratingSize; i++) {
+				Entity entity = iteratingArray->entities[i];
+				Signature const& signature = signatures.get(getIdentifier(entity));
+
+				moveEntityIntoOwningGroup(entity, signature, groupBit);
+			}
+
+			return View<Components...> { this, iteratingArray, metadata };
+		}
+
+		// Releases ownership of the view's pools, the view (and copies of it) must not be used afterwards
+		// Components stay where they are, so other groups over the same pools are unaffected
+		template <OwnershipTag... Components>
+		void destroyView(View<Components...> const& view) {
+			if constexpr (!View<Components...>::_isPartial) {
+				_destroyGroup(view.groupMetadata);
+			}
+		}
+	};
+
+	// https://internalpointers.com/post/writing-custom-iterators-modern-cpp
+	template <OwnershipTag... Components>
+	struct ViewElement {
+		uint64_t index;
+		Entity entity;
+
+		Registry* registry;
 
-					if (pool->isOwned()) {
-						VIVIUM_LOG(LogSeverity::FATAL, "Couldn't create group, already owned by group");
+		// Write access, stamps the component as changed if its pool is tracked
+		template <typename T>
+		T& get() {
+			if constexpr (_isOwnedType<T, Components...>) {
+				TypedComponentArray<T>* pool = static_cast<TypedComponentArray<T>*>(registry->componentPools[TypeGenerator::getIdentifier<T>()]);
+				pool->_stampChanged(index, registry->tick);
+
+				return pool->_getIndex(index);
+			}
+			else {
+				return registry->template getComponent<T>(entity);
+			}
+		}
+
+		template <typename T>
+		T const& read() {
+			if constexpr (_isOwnedType<T, Components...>) {
+				return static_cast<TypedComponentArray<T>*>(registry->componentPools[TypeGenerator::getIdentifier<T>()])->_getIndex(index);
+			}
+			else {
+				return registry->template readComponent<T>(entity);
+			}
+		}
+	};
+
+	template <OwnershipTag... WrappedTypes>
+	struct View {
+		// Views owning any component iterate the owned range of their group, others have to skip
+		//	through a pool testing every entity
+		static constexpr bool _isPartial = !(IsOwnedTag<WrappedTypes>::value || ...);
+
+		Registry* registry;
+		// Pool we iterate, entity array isn't cached since the pool may be reallocated
+		// Partial views pick the smallest pool when iteration begins instead
+		ComponentArray* iteratingArray;
+		// Null for partial views, which aren't groups
+		GroupMetadata* groupMetadata;
+
+		struct ViewIterator {
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = ViewElement<WrappedTypes...>;
+			using pointer = value_type*;
+			using reference = value_type&;
+
+			Entity const* entityArray;
+			uint64_t endIndex;
+
+			value_type current;
+
+			ViewIterator(Registry* registry, Entity const* entityArray, uint64_t startIndex, uint64_t endIndex)
+				: entityArray(entityArray), endIndex(endIndex)
+			{
+				current.index = startIndex;
+				current.registry = registry;
+
+				_settle();
+			}
+
+			// Moves forward to the first matching entity at or after the current index
+			void _settle() {
+				if constexpr (_isPartial) {
+					Signature const& required = View::requiredMask();
+
+					while (current.index < endIndex
+						&& !current.registry->signatures.get(getIdentifier(entityArray[current.index])).includes(required)) {
+						++current.index;
 					}
+				}
+
+				current.entity = current.index < endIndex ? entityArray[current.index] : ECS_ENTITY_DEAD;
+			}
 
-					pool->owner = metadata;
+			reference operator*() { return current; }
+			pointer operator->() { return &current; }
+
+			ViewIterator& operator++() {
+				++current.index;
+
+				_settle();
+
+				return *this;
+			}
+			ViewIterator operator++(int) { ViewIterator tmp = *this; ++(*this); return tmp; }
+
+			bool operator==(ViewIterator const& other) const { return current.index == other.current.index; }
+			bool operator!=(ViewIterator const& other) const { return current.index != other.current.index; }
+		};
+
+		// Smallest pool of the view, every entity of the view is in it
+		ComponentArray* _smallestPool() {
+			ComponentArray* smallest = nullptr;
+
+			((smallest = _selectSmaller(smallest, registry->componentPools[TypeGenerator::getIdentifier<typename WrappedTypes::type>()])), ...);
+
+			return smallest;
+		}
+
+		static ComponentArray* _selectSmaller(ComponentArray* a, ComponentArray* b) {
+			return a == nullptr || b->size < a->size ? b : a;
+		}
+
+		ViewIterator begin() {
+			if constexpr (_isPartial) {
+				ComponentArray* pool = _smallestPool();
+
+				return ViewIterator(registry, pool->entities, 0, pool->size);
+			}
+			else {
+				return ViewIterator(registry, iteratingArray->entities, 0, groupMetadata->groupSize);
+			}
+		}
+
+		ViewIterator end() {
+			if constexpr (_isPartial) {
+				ComponentArray* pool = _smallestPool();
+
+				return ViewIterator(registry, pool->entities, pool->size, pool->size);
+			}
+			else {
+				return ViewIterator(registry, iteratingArray->entities, groupMetadata->groupSize, groupMetadata->groupSize);
+			}
+		}
+
+		// Mask of every component in the view
+		// Component IDs are assigned at runtime, so this is built once per view type rather than at compile-time
+		static Signature const& requiredMask() {
+			static const Signature mask = Signature::of(TypeGenerator::getIdentifier<typename WrappedTypes::type>()...);
+
+			return mask;
+		}
+
+		template <typename T>
+		T* _getArray() {
+			return static_cast<TypedComponentArray<T>*>(registry->componentPools[TypeGenerator::getIdentifier<T>()])->data();
+		}
+
+		// Packed array of an owned component, element i belongs to the same entity in every owned array
+		// Invalidated by any structural change to the registry
+		template <typename T>
+		std::span<T> raw() {
+			static_assert(_isOwnedType<T, WrappedTypes...>, "Raw access requires an owned component");
+			static_assert(!std::is_empty_v<T>, "Tags have no storage");
+
+			return std::span<T>(_getArray<T>(), groupMetadata->groupSize);
+		}
+
+		// raw<T>() as a tuple, empty for tags
+		template <typename T>
+		auto _rawTuple() {
+			if constexpr (std::is_empty_v<T>) {
+				return std::tuple<>();
+			}
+			else {
+				return std::tuple<std::span<T>>(raw<T>());
+			}
+		}
+
+		// Entities of the owned range, aligned by index with raw()
+		std::span<const Entity> entities() {
+			return std::span<const Entity>(iteratingArray->entities, groupMetadata->groupSize);
+		}
+
+		// Calls function(std::span<Ts>..., std::span<const Entity>) once with the whole owned range
+		// Tags have no storage, so get no span
+		template <typename Function>
+		void each(Function&& function) {
+			static_assert((IsOwnedTag<WrappedTypes>::value && ...), "Span iteration requires all components to be owned");
+
+			std::apply([this, &function](auto... spans) {
+				function(spans..., entities());
+			}, std::tuple_cat(_rawTuple<typename WrappedTypes::type>()...));
+		}
+
+		// Calls function(ViewElement&) for each element of the view whose Filter::type component was changed
+		//	(Changed<T>) or added (Added<T>) at or after sinceTick
+		// Only the tick array of that pool is scanned, so the cost is mostly proportional to the number of matches
+		// Span iteration doesn't stamp components, use Registry::markDirty
+		template <ChangeFilter Filter, typename Function>
+		void each(uint32_t sinceTick, Function&& function) {
+			using T = typename Filter::type;
+
+			ComponentArray* pool = registry->componentPools[TypeGenerator::getIdentifier<T>()];
+
+			if (!pool->isTracked()) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Filtered view requires change tracking on the component");
+
+				return;
+			}
+
+			uint32_t const* ticks = IsAddedFilter<Filter>::value ? pool->addedTicks : pool->changedTicks;
+
+			ViewElement<WrappedTypes...> element;
+			element.registry = registry;
+
+			if constexpr (_isOwnedType<T, WrappedTypes...>) {
+				// Owned range of the group is the front of the pool
+				for (uint64_t i = 0; i < groupMetadata->groupSize; i++) {
+					if (ticks[i] < sinceTick) continue;
+
+					element.index = i;
+					element.entity = pool->entities[i];
+
+					function(element);
 				}
-			} (), ...);
+			}
+			else {
+				for (uint64_t i = 0; i < pool->size; i++) {
+					if (ticks[i] < sinceTick) continue;
 
-			if (!ownedGroup) {
-				([&iteratingArray, &iteratingSize, this] {
-					uint32_t id = TypeGenerator::getIdentifier<Components::type>();
-					ComponentArray* pool = this->componentPools[id];
+					Entity entity = pool->entities[i];
 
-					if (pool == nullptr) return;
+					if constexpr (_isPartial) {
+						if (!registry->signatures.get(getIdentifier(entity)).includes(requiredMask())) continue;
 
-					if (pool->size < iteratingSize) {
-						iteratingSize = pool->size;
-						iteratingArray = pool;
+						element.index = i;
 					}
-				} (), ...);
+					else {
+						if (!groupMetadata->containsEntity(entity)) continue;
 
-				metadata->groupSize = iteratingArray->size;
-			}
+						element.index = iteratingArray->sparse.get(getIdentifier(entity));
+					}
 
-			for (uint64_t i = 0; i < iteratingSize; i++) {
-				Entity& entity = iteratingArray->entities[i];
-				Signature& signature = signatures.index(getIdentifier(entity));
+					element.entity = entity;
 
-				if (metadata->ownsSignature(signature)) {
-					moveEntityIntoOwningGroup(entity, signature);
+					function(element);
 				}
 			}
+		}
+
+		// Sorts the owned range by compare(T const&, T const&) on an owned component T, reordering every owned pool
+		// Groups nested in this one are sorted within their own range
+		template <typename T, typename Compare>
+		void sortBy(Compare compare, SortMode mode = SortMode::FULL) {
+			static_assert(_isOwnedType<T, WrappedTypes...>, "Sorting a view requires an owned component");
+			static_assert(!std::is_empty_v<T>, "Tags have no storage to sort by");
 
-			return View<Components...> { this, iteratingArray->entities, metadata };
+			registry->_sortGroupRange(groupMetadata->ownedPools.front()->owners, groupMetadata, _getArray<T>(), compare, mode);
 		}
 
-		// Release ownership for affected pools
-		template <OwnershipTag... Components>
-		void destroyView(View<Components...> const& view) {
-			// TODO
+		// Sorts the owned range by compare(Entity, Entity), e.g. for parent-before-child orderings
+		template <typename Compare>
+		void sortByEntity(Compare compare, SortMode mode = SortMode::FULL) {
+			static_assert(!_isPartial, "Sorting a view requires an owned component");
+
+			registry->_sortGroupRange(groupMetadata->ownedPools.front()->owners, groupMetadata, iteratingArray->entities, compare, mode);
+		}
+
+		// Splits the owned range into chunks, and calls function(std::span<Ts>..., std::span<const Entity>) for each
+		//	chunk on the job system, returning once all chunks are complete
+		// Chunk size is rounded up to a multiple of ECS_CACHE_LINE_SIZE elements, so no two chunks share a cache line
+		// The registry must not be structurally modified until this returns
+		// Tags get no span, as in each()
+		template <typename Function>
+		void parallelForEach(JobSystem& jobSystem, uint64_t chunkSize, Function&& function) {
+			static_assert((IsOwnedTag<WrappedTypes>::value && ...), "Parallel iteration requires all components to be owned");
+
+			std::apply([this, &jobSystem, chunkSize, &function](auto... spans) {
+				_parallelForEach(jobSystem, chunkSize, function, entities(), spans...);
+			}, std::tuple_cat(_rawTuple<typename WrappedTypes::type>()...));
+		}
+
+		template <typename Function, typename... Ts>
+		void _parallelForEach(JobSystem& jobSystem, uint64_t chunkSize, Function& function, std::span<const Entity> entitySpan, std::span<Ts>... spans) {
+			uint64_t count = entitySpan.size();
+
+			chunkSize = std::max<uint64_t>(1, (chunkSize + ECS_CACHE_LINE_SIZE - 1) / ECS_CACHE_LINE_SIZE) * ECS_CACHE_LINE_SIZE;
+
+			for (uint64_t begin = 0; begin < count; begin += chunkSize) {
+				uint64_t length = std::min(chunkSize, count - begin);
+
+				jobSystem.submit([&function, begin, length, entitySpan, spans...] {
+					function(spans.subspan(begin, length)..., entitySpan.subspan(begin, length));
+				});
+			}
+
+			jobSystem.wait();
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "signal.h"
+
+#include <algorithm>
+
+namespace Vivium {
+	ComponentSignal::Connection ComponentSignal::connect(Listener listener)
+	{
+		Connection connection = nextConnection++;
+
+		// Appending could reallocate listeners while one of them is running
+		std::vector<ConnectedListener>& destination = delivering == 0 ? listeners : connecting;
+		destination.push_back(ConnectedListener{ connection, std::move(listener) });
+
+		return connection;
+	}
+
+	void ComponentSignal::disconnect(Connection connection)
+	{
+		auto matches = [connection](ConnectedListener const& connected) { return connected.connection == connection; };
+
+		std::erase_if(connecting, matches);
+
+		if (delivering == 0) {
+			std::erase_if(listeners, matches);
+
+			return;
+		}
+
+		// Erasing would shift the listeners still to be called, and may destroy the running one
+		for (ConnectedListener& connected : listeners) {
+			if (!matches(connected)) continue;
+
+			connected.connection = disconnectedConnection;
+			disconnecting = true;
+		}
+	}
+
+	void ComponentSignal::setDeferred(bool value)
+	{
+		deferred = value;
+	}
+
+	void ComponentSignal::_deliver(Registry& registry, Entity entity)
+	{
+		++delivering;
+
+		for (ConnectedListener& connected : listeners) {
+			if (connected.connection == disconnectedConnection) continue;
+
+			connected.listener(registry, entity);
+		}
+
+		if (--delivering == 0 && (disconnecting || !connecting.empty())) {
+			_applyConnectionChanges();
+		}
+	}
+
+	void ComponentSignal::_applyConnectionChanges()
+	{
+		if (disconnecting) {
+			std::erase_if(listeners, [](ConnectedListener const& connected) { return connected.connection == disconnectedConnection; });
+
+			disconnecting = false;
+		}
+
+		for (ConnectedListener& connected : connecting) {
+			listeners.push_back(std::move(connected));
+		}
+
+		connecting.clear();
+	}
+
+	void ComponentSignal::flush(Registry& registry)
+	{
+		// Listeners may cause more events, which are delivered in the next flush
+		std::vector<Entity> events;
+		std::swap(events, pending);
+
+		for (Entity entity : events) {
+			_deliver(registry, entity);
+		}
+
+		// Keep the allocation for the next frame
+		if (pending.empty()) {
+			events.clear();
+			std::swap(events, pending);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "defines.h"
+
+#include <functional>
+#include <vector>
+
+namespace Vivium {
+	struct Registry;
+
+	// Listeners of one component event (construct, destroy or update) of one pool
+	// Immediate signals call listeners as the event happens, deferred signals queue the entity until
+	//	Registry::flushSignals, so listeners see a batch once per frame instead of every change
+	// Listeners may connect and disconnect listeners, which takes effect once delivery ends
+	struct ComponentSignal {
+		typedef std::function<void(Registry&, Entity)> Listener;
+		typedef uint64_t Connection;
+
+		// Marks a listener disconnected during delivery, removed once delivery ends
+		static constexpr Connection disconnectedConnection = ~Connection(0);
+
+		struct ConnectedListener {
+			Connection connection;
+			Listener listener;
+		};
+
+		std::vector<ConnectedListener> listeners;
+		Connection nextConnection = 0;
+
+		// Nested deliveries in progress, listeners aren't added or erased while non-zero
+		uint32_t delivering = 0;
+		// Connected during delivery, appended to listeners once it ends
+		std::vector<ConnectedListener> connecting;
+		bool disconnecting = false;
+
+		bool deferred = false;
+		// Entities of events not yet delivered, in order, only used when deferred
+		std::vector<Entity> pending;
+
+		Connection connect(Listener listener);
+		void disconnect(Connection connection);
+
+		// Queue events until flush() instead of delivering them immediately
+		// Deferred destroy events are delivered after the component is gone
+		void setDeferred(bool value);
+
+		bool empty() const {
+			return listeners.empty();
+		}
+
+		void publish(Registry& registry, Entity entity) {
+			if (listeners.empty()) return;
+
+			if (deferred) {
+				pending.push_back(entity);
+
+				return;
+			}
+
+			_deliver(registry, entity);
+		}
+
+		void _deliver(Registry& registry, Entity entity);
+		// Applies connects and disconnects made during delivery
+		void _applyConnectionChanges();
+		// Delivers all pending events
+		void flush(Registry& registry);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// Every path is compiled where the target supports it, so they can be tested against each other
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VIVIUM_SIGNATURE_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VIVIUM_SIGNATURE_SSE2
+#endif
+
+namespace Vivium {
+	constexpr uint64_t ECS_SIGNATURE_WORDS = 4;
+	constexpr uint64_t ECS_SIGNATURE_BITS = ECS_SIGNATURE_WORDS * 64;
+
+	// Fixed 256-bit component mask, bit i is set if the entity has component i
+	// Usable in constant expressions; subset tests use AVX2/SSE2 when available
+	struct alignas(32) Signature {
+		std::array<uint64_t, ECS_SIGNATURE_WORDS> words;
+
+		constexpr Signature() : words{} {}
+
+		constexpr bool test(uint64_t bit) const {
+			return (words[bit >> 6] >> (bit & 63)) & 1;
+		}
+
+		constexpr Signature& set(uint64_t bit, bool value = true) {
+			uint64_t mask = uint64_t(1) << (bit & 63);
+
+			if (value) words[bit >> 6] |= mask;
+			else words[bit >> 6] &= ~mask;
+
+			return *this;
+		}
+
+		constexpr Signature& reset(uint64_t bit) { return set(bit, false); }
+
+		constexpr bool any() const { return (words[0] | words[1] | words[2] | words[3]) != 0; }
+		constexpr bool none() const { return !any(); }
+
+		constexpr uint64_t count() const {
+			return std::popcount(words[0]) + std::popcount(words[1]) + std::popcount(words[2]) + std::popcount(words[3]);
+		}
+
+		// True if every bit of subset is also set in this
+		constexpr bool includes(Signature const& subset) const {
+			if (!std::is_constant_evaluated()) {
+#if defined(VIVIUM_SIGNATURE_AVX2)
+				return _includesAVX2(subset);
+#elif defined(VIVIUM_SIGNATURE_SSE2)
+				return _includesSSE2(subset);
+#endif
+			}
+
+			return _includesScalar(subset);
+		}
+
+		constexpr bool _includesScalar(Signature const& subset) const {
+			return ((subset.words[0] & ~words[0]) | (subset.words[1] & ~words[1])
+				| (subset.words[2] & ~words[2]) | (subset.words[3] & ~words[3])) == 0;
+		}
+
+#if defined(VIVIUM_SIGNATURE_AVX2)
+		bool _includesAVX2(Signature const& subset) const {
+			__m256i ours = _mm256_load_si256(reinterpret_cast<__m256i const*>(words.data()));
+			__m256i theirs = _mm256_load_si256(reinterpret_cast<__m256i const*>(subset.words.data()));
+
+			// Carry flag is set if (~ours & theirs) is zero
+			return _mm256_testc_si256(ours, theirs);
+		}
+#endif
+
+#if defined(VIVIUM_SIGNATURE_SSE2)
+		bool _includesSSE2(Signature const& subset) const {
+			__m128i oursLow = _mm_load_si128(reinterpret_cast<__m128i const*>(words.data()));
+			__m128i oursHigh = _mm_load_si128(reinterpret_cast<__m128i const*>(words.data() + 2));
+			__m128i theirsLow = _mm_load_si128(reinterpret_cast<__m128i const*>(subset.words.data()));
+			__m128i theirsHigh = _mm_load_si128(reinterpret_cast<__m128i const*>(subset.words.data() + 2));
+
+			__m128i missing = _mm_or_si128(_mm_andnot_si128(oursLow, theirsLow), _mm_andnot_si128(oursHigh, theirsHigh));
+
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xffff;
+		}
+#endif
+
+		// True if this and other share any bit
+		constexpr bool intersects(Signature const& other) const {
+			return ((words[0] & other.words[0]) | (words[1] & other.words[1])
+				| (words[2] & other.words[2]) | (words[3] & other.words[3])) != 0;
+		}
+
+		constexpr Signature operator&(Signature const& other) const {
+			Signature result;
+
+			for (uint64_t i = 0; i < ECS_SIGNATURE_WORDS; i++) result.words[i] = words[i] & other.words[i];
+
+			return result;
+		}
+
+		constexpr Signature operator|(Signature const& other) const {
+			Signature result;
+
+			for (uint64_t i = 0; i < ECS_SIGNATURE_WORDS; i++) result.words[i] = words[i] | other.words[i];
+
+			return result;
+		}
+
+		constexpr Signature& operator&=(Signature const& other) { return *this = *this & other; }
+		constexpr Signature& operator|=(Signature const& other) { return *this = *this | other; }
+
+		constexpr bool operator==(Signature const& other) const { return words == other.words; }
+
+		// Mask of the given component IDs
+		template <typename... IDs>
+		static constexpr Signature of(IDs... ids) {
+			Signature result;
+
+			(result.set(static_cast<uint64_t>(ids)), ...);
+
+			return result;
+		}
+	};
+}
+
+template <>
+struct std::hash<Vivium::Signature> {
+	size_t operator()(Vivium::Signature const& signature) const {
+		uint64_t hash = 0;
+
+		for (uint64_t word : signature.words) {
+			hash = (hash ^ word) * 0x100000001b3ULL;
+			hash ^= hash >> 32;
+		}
+
+		return static_cast<size_t>(hash);
+	}
+};
\ No newline at end of file
@@ -1,13 +1,43 @@
 #include "aabb.h"
 
+#include <algorithm>
+
 namespace Vivium {
+	bool AABB::intersects(AABB const& other) const
+	{
+		return AABBIntersectAABB(min, max, other.min, other.max);
+	}
+
+	bool AABB::contains(AABB const& other) const
+	{
+		return min.x <= other.min.x && min.y <= other.min.y && max.x >= other.max.x && max.y >= other.max.y;
+	}
+
+	float AABB::perimeter() const
+	{
+		return 2.0f * ((max.x - min.x) + (max.y - min.y));
+	}
+
+	AABB AABB::combine(AABB const& a, AABB const& b)
+	{
+		return AABB{
+			F32x2(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)),
+			F32x2(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y))
+		};
+	}
+
+	AABB AABB::fatten(AABB const& box, float margin)
+	{
+		return AABB{ box.min - F32x2(margin), box.max + F32x2(margin) };
+	}
+
 	bool pointInAABB(F32x2 point, F32x2 min, F32x2 max) {
 		return min.x <= point.x && max.x >= point.x && min.y <= point.y && max.y >= point.y;
 	}
 
-	// TODO: check this AABB check actually makes sense
+	// Separated if either box is entirely to one side of the other on some axis
 	bool AABBIntersectAABB(F32x2 min1, F32x2 max1, F32x2 min2, F32x2 max2) {
-		return (min1.x <= max2.x || min2.x >= max1.x) && (min1.y <= max2.y || min2.y >= max1.y);
+		return min1.x <= max2.x && min2.x <= max1.x && min1.y <= max2.y && min2.y <= max1.y;
 	}
 		
 	F32x2 applyTransform(F32x2 point, Transform transform)
@@ -4,9 +4,23 @@
 #include "transform.h"
 
 namespace Vivium {
+	struct AABB {
+		F32x2 min;
+		F32x2 max;
+
+		// Touching boxes count as intersecting
+		bool intersects(AABB const& other) const;
+		bool contains(AABB const& other) const;
+		// Cost metric of bounding volume hierarchies, the 2D equivalent of surface area
+		float perimeter() const;
+
+		static AABB combine(AABB const& a, AABB const& b);
+		// Grown by margin on every side
+		static AABB fatten(AABB const& box, float margin);
+	};
+
 	bool pointInAABB(F32x2 point, F32x2 min, F32x2 max);
 
-	// TODO: check this AABB check actually makes sense
 	bool AABBIntersectAABB(F32x2 min1, F32x2 max1, F32x2 min2, F32x2 max2);
 
 	// TODO: these should not be in AABB
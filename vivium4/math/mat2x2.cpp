@@ -21,7 +21,7 @@ namespace Vivium {
 		float cosAngle = std::cos(angle);
 		float sinAngle = std::sin(angle);
 
-		return Mat2x2(cosAngle, -sinAngle, sinAngle, cosAngle);
+		return Mat2x2(cosAngle, sinAngle, -sinAngle, cosAngle);
 	}
 		
 	Mat2x2 Mat2x2::identity()
@@ -15,6 +15,7 @@ namespace Vivium {
 
 		Mat2x2 transpose();
 
+		// Counter-clockwise, the same direction as positive angular velocity from F32x2::cross
 		static Mat2x2 fromAngle(float angle);
 		static Mat2x2 identity();
 	};
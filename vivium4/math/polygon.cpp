@@ -22,13 +22,13 @@ namespace Vivium {
 		return center / area;
 	}
 
-	F32x2 supportPolygon(Polygon const& polygon, F32x2 direction)
+	F32x2 supportPoints(std::span<const F32x2> points, F32x2 direction)
 	{
-		float maxDotProduct = std::numeric_limits<float>::lowest();
-		F32x2 bestPoint = polygon.vertices[0];
+		float maxDotProduct = F32x2::dot(points[0], direction);
+		F32x2 bestPoint = points[0];
 
-		for (uint64_t i = 1; i < polygon.vertices.size(); i++) {
-			F32x2 point = polygon.vertices[i];
+		for (uint64_t i = 1; i < points.size(); i++) {
+			F32x2 point = points[i];
 
 			float dot = F32x2::dot(point, direction);
 
@@ -41,6 +41,11 @@ namespace Vivium {
 		return bestPoint;
 	}
 
+	F32x2 supportPolygon(Polygon const& polygon, F32x2 direction)
+	{
+		return supportPoints(polygon.vertices, direction);
+	}
+
 	float inertiaPolygon(Polygon const& polygon)
 	{
 		constexpr float twelth = 1.0f / 12.0f;
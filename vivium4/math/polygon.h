@@ -19,6 +19,8 @@ namespace Vivium {
 	};
 
 	F32x2 centroidPolygon(Polygon const& polygon);
+	// Point furthest in direction
+	F32x2 supportPoints(std::span<const F32x2> points, F32x2 direction);
 	F32x2 supportPolygon(Polygon const& polygon, F32x2 direction);
 	float inertiaPolygon(Polygon const& polygon);
 	float areaPolygon(Polygon const& polygon);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+// Widest float vector the compiler is targeting, AVX if enabled (/arch:AVX, -mavx), otherwise SSE, which
+//	every x64 target has
+// Falls back to a single float lane, so kernels written against these functions build anywhere
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VIVIUM_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VIVIUM_SIMD_SSE
+#endif
+
+namespace Vivium {
+	namespace Simd {
+#if defined(VIVIUM_SIMD_AVX)
+		using Floats = __m256;
+		inline constexpr uint64_t width = 8;
+
+		inline Floats load(float const* source) { return _mm256_loadu_ps(source); }
+		inline void store(float* destination, Floats value) { _mm256_storeu_ps(destination, value); }
+		inline Floats broadcast(float value) { return _mm256_set1_ps(value); }
+		inline Floats zero() { return _mm256_setzero_ps(); }
+		inline Floats add(Floats a, Floats b) { return _mm256_add_ps(a, b); }
+		inline Floats mul(Floats a, Floats b) { return _mm256_mul_ps(a, b); }
+#elif defined(VIVIUM_SIMD_SSE)
+		using Floats = __m128;
+		inline constexpr uint64_t width = 4;
+
+		inline Floats load(float const* source) { return _mm_loadu_ps(source); }
+		inline void store(float* destination, Floats value) { _mm_storeu_ps(destination, value); }
+		inline Floats broadcast(float value) { return _mm_set1_ps(value); }
+		inline Floats zero() { return _mm_setzero_ps(); }
+		inline Floats add(Floats a, Floats b) { return _mm_add_ps(a, b); }
+		inline Floats mul(Floats a, Floats b) { return _mm_mul_ps(a, b); }
+#else
+		using Floats = float;
+		inline constexpr uint64_t width = 1;
+
+		inline Floats load(float const* source) { return *source; }
+		inline void store(float* destination, Floats value) { *destination = value; }
+		inline Floats broadcast(float value) { return value; }
+		inline Floats zero() { return 0.0f; }
+		inline Floats add(Floats a, Floats b) { return a + b; }
+		inline Floats mul(Floats a, Floats b) { return a * b; }
+#endif
+	}
+}
\ No newline at end of file
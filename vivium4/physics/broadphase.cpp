@@ -0,0 +1,469 @@
+#include "broadphase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Vivium {
+	namespace Physics {
+		DynamicAABBTree::DynamicAABBTree(float margin)
+			: margin(margin)
+		{}
+
+		uint32_t DynamicAABBTree::insert(AABB const& bounds, uint32_t body)
+		{
+			uint32_t proxy = _allocateNode();
+
+			Node& node = nodes[proxy];
+			node.bounds = AABB::fatten(bounds, margin);
+			node.body = body;
+			node.height = 0;
+
+			_insertLeaf(proxy);
+
+			return proxy;
+		}
+
+		void DynamicAABBTree::remove(uint32_t proxy)
+		{
+			_removeLeaf(proxy);
+			_freeNode(proxy);
+		}
+
+		bool DynamicAABBTree::move(uint32_t proxy, AABB const& bounds)
+		{
+			if (nodes[proxy].bounds.contains(bounds)) return false;
+
+			_removeLeaf(proxy);
+			nodes[proxy].bounds = AABB::fatten(bounds, margin);
+			_insertLeaf(proxy);
+
+			return true;
+		}
+
+		uint32_t DynamicAABBTree::_allocateNode()
+		{
+			uint32_t index;
+
+			if (freeList != nullNode) {
+				index = freeList;
+				freeList = nodes[index].parent;
+			}
+			else {
+				index = static_cast<uint32_t>(nodes.size());
+				nodes.emplace_back();
+			}
+
+			Node& node = nodes[index];
+			node.parent = node.left = node.right = nullNode;
+			node.height = 0;
+			node.body = nullNode;
+
+			return index;
+		}
+
+		void DynamicAABBTree::_freeNode(uint32_t node)
+		{
+			nodes[node].parent = freeList;
+			nodes[node].height = -1;
+			freeList = node;
+		}
+
+		void DynamicAABBTree::_insertLeaf(uint32_t leaf)
+		{
+			if (root == nullNode) {
+				root = leaf;
+				nodes[root].parent = nullNode;
+
+				return;
+			}
+
+			AABB leafBounds = nodes[leaf].bounds;
+
+			// Descend to the sibling that grows the tree's total perimeter the least
+			uint32_t index = root;
+
+			while (!nodes[index].isLeaf()) {
+				Node const& node = nodes[index];
+
+				float combinedPerimeter = AABB::combine(node.bounds, leafBounds).perimeter();
+
+				// Cost of pairing with this node, and of the growth every ancestor inherits if going further down
+				float cost = 2.0f * combinedPerimeter;
+				float inheritanceCost = 2.0f * (combinedPerimeter - node.bounds.perimeter());
+
+				auto descendCost = [this, &leafBounds, inheritanceCost](uint32_t child) {
+					Node const& childNode = nodes[child];
+					float perimeter = AABB::combine(childNode.bounds, leafBounds).perimeter();
+
+					return (childNode.isLeaf() ? perimeter : perimeter - childNode.bounds.perimeter()) + inheritanceCost;
+				};
+
+				float leftCost = descendCost(node.left);
+				float rightCost = descendCost(node.right);
+
+				if (cost < leftCost && cost < rightCost) break;
+
+				index = leftCost < rightCost ? node.left : node.right;
+			}
+
+			uint32_t sibling = index;
+			uint32_t oldParent = nodes[sibling].parent;
+			// May reallocate nodes
+			uint32_t newParent = _allocateNode();
+
+			nodes[newParent].parent = oldParent;
+			nodes[newParent].bounds = AABB::combine(leafBounds, nodes[sibling].bounds);
+			nodes[newParent].height = nodes[sibling].height + 1;
+			nodes[newParent].left = sibling;
+			nodes[newParent].right = leaf;
+
+			nodes[sibling].parent = newParent;
+			nodes[leaf].parent = newParent;
+
+			if (oldParent == nullNode) {
+				root = newParent;
+			}
+			else if (nodes[oldParent].left == sibling) {
+				nodes[oldParent].left = newParent;
+			}
+			else {
+				nodes[oldParent].right = newParent;
+			}
+
+			// Refit and rebalance the ancestors
+			index = nodes[leaf].parent;
+
+			while (index != nullNode) {
+				index = _balance(index);
+
+				Node& node = nodes[index];
+				node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+				node.bounds = AABB::combine(nodes[node.left].bounds, nodes[node.right].bounds);
+
+				index = node.parent;
+			}
+		}
+
+		void DynamicAABBTree::_removeLeaf(uint32_t leaf)
+		{
+			if (leaf == root) {
+				root = nullNode;
+
+				return;
+			}
+
+			uint32_t parent = nodes[leaf].parent;
+			uint32_t grandParent = nodes[parent].parent;
+			uint32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+			// Sibling takes the place of the parent
+			_freeNode(parent);
+			nodes[sibling].parent = grandParent;
+
+			if (grandParent == nullNode) {
+				root = sibling;
+
+				return;
+			}
+
+			if (nodes[grandParent].left == parent) {
+				nodes[grandParent].left = sibling;
+			}
+			else {
+				nodes[grandParent].right = sibling;
+			}
+
+			uint32_t index = grandParent;
+
+			while (index != nullNode) {
+				index = _balance(index);
+
+				Node& node = nodes[index];
+				node.height = 1 + std::max(nodes[node.left].height, nodes[node.right].height);
+				node.bounds = AABB::combine(nodes[node.left].bounds, nodes[node.right].bounds);
+
+				index = node.parent;
+			}
+		}
+
+		uint32_t DynamicAABBTree::_balance(uint32_t indexA)
+		{
+			Node& a = nodes[indexA];
+
+			if (a.isLeaf() || a.height < 2) return indexA;
+
+			uint32_t indexB = a.left;
+			uint32_t indexC = a.right;
+
+			Node& b = nodes[indexB];
+			Node& c = nodes[indexC];
+
+			int32_t balance = c.height - b.height;
+
+			// Rotate c up, a takes whichever of c's children is shorter
+			if (balance > 1) {
+				uint32_t indexF = c.left;
+				uint32_t indexG = c.right;
+
+				Node& f = nodes[indexF];
+				Node& g = nodes[indexG];
+
+				c.left = indexA;
+				c.parent = a.parent;
+				a.parent = indexC;
+
+				if (c.parent == nullNode) {
+					root = indexC;
+				}
+				else if (nodes[c.parent].left == indexA) {
+					nodes[c.parent].left = indexC;
+				}
+				else {
+					nodes[c.parent].right = indexC;
+				}
+
+				if (f.height > g.height) {
+					c.right = indexF;
+					a.right = indexG;
+					g.parent = indexA;
+
+					a.bounds = AABB::combine(b.bounds, g.bounds);
+					c.bounds = AABB::combine(a.bounds, f.bounds);
+
+					a.height = 1 + std::max(b.height, g.height);
+					c.height = 1 + std::max(a.height, f.height);
+				}
+				else {
+					c.right = indexG;
+					a.right = indexF;
+					f.parent = indexA;
+
+					a.bounds = AABB::combine(b.bounds, f.bounds);
+					c.bounds = AABB::combine(a.bounds, g.bounds);
+
+					a.height = 1 + std::max(b.height, f.height);
+					c.height = 1 + std::max(a.height, g.height);
+				}
+
+				return indexC;
+			}
+
+			// Rotate b up
+			if (balance < -1) {
+				uint32_t indexD = b.left;
+				uint32_t indexE = b.right;
+
+				Node& d = nodes[indexD];
+				Node& e = nodes[indexE];
+
+				b.left = indexA;
+				b.parent = a.parent;
+				a.parent = indexB;
+
+				if (b.parent == nullNode) {
+					root = indexB;
+				}
+				else if (nodes[b.parent].left == indexA) {
+					nodes[b.parent].left = indexB;
+				}
+				else {
+					nodes[b.parent].right = indexB;
+				}
+
+				if (d.height > e.height) {
+					b.right = indexD;
+					a.left = indexE;
+					e.parent = indexA;
+
+					a.bounds = AABB::combine(c.bounds, e.bounds);
+					b.bounds = AABB::combine(a.bounds, d.bounds);
+
+					a.height = 1 + std::max(c.height, e.height);
+					b.height = 1 + std::max(a.height, d.height);
+				}
+				else {
+					b.right = indexE;
+					a.left = indexD;
+					d.parent = indexA;
+
+					a.bounds = AABB::combine(c.bounds, d.bounds);
+					b.bounds = AABB::combine(a.bounds, e.bounds);
+
+					a.height = 1 + std::max(c.height, d.height);
+					b.height = 1 + std::max(a.height, e.height);
+				}
+
+				return indexB;
+			}
+
+			return indexA;
+		}
+
+		TreeBroadphase::TreeBroadphase(float margin)
+			: tree(margin)
+		{}
+
+		bool TreeBroadphase::update(std::span<const AABB> bounds)
+		{
+			bool changed = false;
+
+			while (proxies.size() > bounds.size()) {
+				tree.remove(proxies.back());
+				proxies.pop_back();
+
+				changed = true;
+			}
+
+			for (uint64_t i = 0; i < proxies.size(); i++) {
+				if (tree.move(proxies[i], bounds[i])) changed = true;
+			}
+
+			for (uint64_t i = proxies.size(); i < bounds.size(); i++) {
+				proxies.push_back(tree.insert(bounds[i], static_cast<uint32_t>(i)));
+
+				changed = true;
+			}
+
+			return changed;
+		}
+
+		std::span<const BodyPair> TreeBroadphase::findPairs()
+		{
+			pairs.clear();
+
+			for (uint32_t i = 0; i < proxies.size(); i++) {
+				tree.query(tree.nodes[proxies[i]].bounds, [this, i](uint32_t body) {
+					// Each pair is found from both bodies, keep the one found from the lower
+					if (body > i) pairs.push_back(BodyPair{ i, body });
+				});
+			}
+
+			return pairs;
+		}
+
+		bool SweepAndPrune::update(std::span<const AABB> newBounds)
+		{
+			bounds.assign(newBounds.begin(), newBounds.end());
+
+			auto lessX = [this](uint32_t a, uint32_t b) { return bounds[a].min.x < bounds[b].min.x; };
+
+			if (order.size() != bounds.size()) {
+				order.resize(bounds.size());
+				std::iota(order.begin(), order.end(), 0);
+				std::sort(order.begin(), order.end(), lessX);
+
+				return true;
+			}
+
+			// Insertion sort, bodies rarely pass each other between steps
+			for (uint64_t i = 1; i < order.size(); i++) {
+				uint32_t body = order[i];
+				uint64_t j = i;
+
+				while (j > 0 && lessX(body, order[j - 1])) {
+					order[j] = order[j - 1];
+					--j;
+				}
+
+				order[j] = body;
+			}
+
+			return true;
+		}
+
+		std::span<const BodyPair> SweepAndPrune::findPairs()
+		{
+			pairs.clear();
+
+			for (uint64_t i = 0; i < order.size(); i++) {
+				AABB const& a = bounds[order[i]];
+
+				for (uint64_t j = i + 1; j < order.size(); j++) {
+					AABB const& b = bounds[order[j]];
+
+					// Every later body starts further along x
+					if (b.min.x > a.max.x) break;
+
+					if (a.min.y <= b.max.y && b.min.y <= a.max.y) {
+						pairs.push_back(BodyPair{ std::min(order[i], order[j]), std::max(order[i], order[j]) });
+					}
+				}
+			}
+
+			return pairs;
+		}
+
+		UniformGrid::UniformGrid(float cellSize)
+			: cellSize(cellSize)
+		{}
+
+		uint64_t UniformGrid::_cellKey(int32_t x, int32_t y) const
+		{
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+		}
+
+		bool UniformGrid::update(std::span<const AABB> newBounds)
+		{
+			bounds.assign(newBounds.begin(), newBounds.end());
+			entries.clear();
+
+			float inverseCellSize = 1.0f / cellSize;
+
+			for (uint32_t i = 0; i < bounds.size(); i++) {
+				int32_t minX = static_cast<int32_t>(std::floor(bounds[i].min.x * inverseCellSize));
+				int32_t minY = static_cast<int32_t>(std::floor(bounds[i].min.y * inverseCellSize));
+				int32_t maxX = static_cast<int32_t>(std::floor(bounds[i].max.x * inverseCellSize));
+				int32_t maxY = static_cast<int32_t>(std::floor(bounds[i].max.y * inverseCellSize));
+
+				for (int32_t x = minX; x <= maxX; x++) {
+					for (int32_t y = minY; y <= maxY; y++) {
+						entries.push_back(CellEntry{ _cellKey(x, y), i });
+					}
+				}
+			}
+
+			std::sort(entries.begin(), entries.end(), [](CellEntry const& a, CellEntry const& b) {
+				return a.cell == b.cell ? a.body < b.body : a.cell < b.cell;
+			});
+
+			return true;
+		}
+
+		std::span<const BodyPair> UniformGrid::findPairs()
+		{
+			pairs.clear();
+
+			float inverseCellSize = 1.0f / cellSize;
+
+			for (uint64_t start = 0; start < entries.size();) {
+				uint64_t end = start + 1;
+
+				while (end < entries.size() && entries[end].cell == entries[start].cell) ++end;
+
+				for (uint64_t i = start; i < end; i++) {
+					for (uint64_t j = i + 1; j < end; j++) {
+						uint32_t a = entries[i].body;
+						uint32_t b = entries[j].body;
+
+						if (!bounds[a].intersects(bounds[b])) continue;
+
+						// Bodies share every cell their overlap covers, report the pair only from the cell
+						//	holding the min corner of the overlap
+						int32_t overlapX = static_cast<int32_t>(std::floor(std::max(bounds[a].min.x, bounds[b].min.x) * inverseCellSize));
+						int32_t overlapY = static_cast<int32_t>(std::floor(std::max(bounds[a].min.y, bounds[b].min.y) * inverseCellSize));
+
+						if (_cellKey(overlapX, overlapY) != entries[i].cell) continue;
+
+						// Sorted by body within a cell
+						pairs.push_back(BodyPair{ a, b });
+					}
+				}
+
+				start = end;
+			}
+
+			return pairs;
+		}
+	}
+}
\ No newline at end of file
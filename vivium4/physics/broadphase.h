@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../math/aabb.h"
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Vivium {
+	namespace Physics {
+		// Indices of two bodies whose bounds may overlap, a < b
+		struct BodyPair {
+			uint32_t a, b;
+		};
+
+		// Finds candidate pairs for the narrow phase from the bounds of every body, indexed as in the
+		//	span of bodies given to solve
+		// update() is given the bounds of every body each step, and returns if the candidate pairs may have
+		//	changed since the last update, if not, the pairs found last may be reused
+		// findPairs() returns each candidate pair once, and may return pairs that don't overlap
+		template <typename T>
+		concept Broadphase = requires(T broadphase, std::span<const AABB> bounds) {
+			{ broadphase.update(bounds) } -> std::same_as<bool>;
+			{ broadphase.findPairs() } -> std::same_as<std::span<const BodyPair>>;
+		};
+
+		// Bounding volume hierarchy over fattened leaf bounds, incrementally updated
+		// A leaf is only reinserted once its body leaves the fattened bounds, so slow bodies cost nothing
+		//	to update, and the candidate pairs are unchanged for as long as no leaf is reinserted
+		// Reinsertion picks the sibling of least perimeter cost, and rotations keep the tree balanced
+		struct DynamicAABBTree {
+			static constexpr uint32_t nullNode = UINT32_MAX;
+
+			struct Node {
+				// Fattened for leaves
+				AABB bounds;
+				// Next free node, for nodes in the free list
+				uint32_t parent;
+				uint32_t left, right;
+				// Leaves are height 0, free nodes are -1
+				int32_t height;
+				uint32_t body;
+
+				bool isLeaf() const { return left == nullNode; }
+			};
+
+			std::vector<Node> nodes;
+			uint32_t root = nullNode;
+			uint32_t freeList = nullNode;
+
+			float margin;
+
+			DynamicAABBTree(float margin = 0.1f);
+
+			// Returns the leaf (proxy) of body
+			uint32_t insert(AABB const& bounds, uint32_t body);
+			void remove(uint32_t proxy);
+			// Returns if the proxy was reinserted, because bounds are no longer within its fattened bounds
+			bool move(uint32_t proxy, AABB const& bounds);
+
+			// Calls function(body) for each leaf whose fattened bounds intersect bounds
+			template <typename Function>
+			void query(AABB const& bounds, Function&& function) const {
+				if (root == nullNode) return;
+
+				// Enough for any tree the rotations keep balanced, moves to the heap if it isn't
+				uint32_t fixedStack[128];
+				std::vector<uint32_t> grownStack;
+
+				uint32_t* stack = fixedStack;
+				uint64_t stackCapacity = 128;
+				uint64_t stackSize = 0;
+
+				stack[stackSize++] = root;
+
+				while (stackSize > 0) {
+					Node const& node = nodes[stack[--stackSize]];
+
+					if (!node.bounds.intersects(bounds)) continue;
+
+					if (node.isLeaf()) {
+						function(node.body);
+					}
+					else {
+						if (stackSize + 2 > stackCapacity) {
+							if (grownStack.empty()) grownStack.assign(fixedStack, fixedStack + stackSize);
+
+							stackCapacity *= 2;
+							grownStack.resize(stackCapacity);
+							stack = grownStack.data();
+						}
+
+						stack[stackSize++] = node.left;
+						stack[stackSize++] = node.right;
+					}
+				}
+			}
+
+			uint32_t _allocateNode();
+			void _freeNode(uint32_t node);
+			void _insertLeaf(uint32_t leaf);
+			void _removeLeaf(uint32_t leaf);
+			// Rotates the subtree at node if its children differ in height by more than one, returns the
+			//	new subtree root
+			uint32_t _balance(uint32_t node);
+		};
+
+		// Body i owns proxy i of the tree, bodies are added and removed as the span of bounds grows and shrinks
+		struct TreeBroadphase {
+			DynamicAABBTree tree;
+			std::vector<uint32_t> proxies;
+			std::vector<BodyPair> pairs;
+
+			TreeBroadphase(float margin = 0.1f);
+
+			bool update(std::span<const AABB> bounds);
+			std::span<const BodyPair> findPairs();
+		};
+
+		// Sorts bodies along x and sweeps for overlaps, checking y only for those overlapping on x
+		// The order is kept between steps, so re-sorting a scene that barely moved is close to linear
+		// Best for bodies spread along x, bodies stacked in columns are all overlapping on x
+		struct SweepAndPrune {
+			std::vector<AABB> bounds;
+			// Body indices sorted by min.x
+			std::vector<uint32_t> order;
+			std::vector<BodyPair> pairs;
+
+			bool update(std::span<const AABB> bounds);
+			std::span<const BodyPair> findPairs();
+		};
+
+		// Buckets bodies into square cells of cellSize, and tests bodies that share a cell
+		// Best for bodies of similar size, around a cell in size, a body spanning many cells is inserted into
+		//	every one of them
+		struct UniformGrid {
+			struct CellEntry {
+				uint64_t cell;
+				uint32_t body;
+			};
+
+			float cellSize;
+
+			std::vector<AABB> bounds;
+			// Sorted by cell
+			std::vector<CellEntry> entries;
+			std::vector<BodyPair> pairs;
+
+			UniformGrid(float cellSize);
+
+			bool update(std::span<const AABB> bounds);
+			std::span<const BodyPair> findPairs();
+
+			uint64_t _cellKey(int32_t x, int32_t y) const;
+		};
+	}
+}
\ No newline at end of file
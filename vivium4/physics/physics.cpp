@@ -3,7 +3,7 @@
 namespace Vivium {
 	namespace Physics {
 		PenetrationManifold::PenetrationManifold()
-			: depth(0.0f), vector(0.0f), contacts({F32x2(0.0f), F32x2(0.0f)}), contactCount(0)
+			: depth(0.0f), vector(0.0f), contacts({F32x2(0.0f), F32x2(0.0f)}), depths({0.0f, 0.0f}), features({0, 0}), contactCount(0)
 		{}
 		
 		EdgeManifold axisOfLeastPenetration(const Polygon& a, const Polygon& b, const Transform& aTransform, const Transform& bTransform)
@@ -72,31 +72,23 @@ namespace Vivium {
 		uint64_t clip(F32x2 edgeVector, float side, std::array<F32x2, MAX_CONTACT_COUNT>& face)
 		{
 			uint32_t outIndex = 0;
-			F32x2 out[2] = {
-				face[0],
-				face[1]
-			};
 
 			// Distances from each endpoint to the line
 			float distanceFace0 = F32x2::dot(edgeVector, face[0]) - side;
 			float distanceFace1 = F32x2::dot(edgeVector, face[1]) - side;
 
 			// If behind plane
-			if (distanceFace0 <= 0.0f) out[outIndex++] = face[0];
-			if (distanceFace1 <= 0.0f) out[outIndex++] = face[1];
+			if (distanceFace0 <= 0.0f) ++outIndex;
+			if (distanceFace1 <= 0.0f) ++outIndex;
 
-			// If they have opposite sign/different side of plane
-			// outIndex < 2 is just sanity check, not mathematically possible for
-			//	distance faces to have different signs and outIndex >= 2
+			// If they have opposite sign/different side of plane, the point in front is moved onto the plane
+			// Points keep their slot, so contact features stay with the same incident vertex
 			if (outIndex < 2 && distanceFace0 * distanceFace1 < 0.0f) {
 				float alpha = distanceFace0 / (distanceFace0 - distanceFace1);
-				out[outIndex] = face[0] + alpha * (face[1] - face[0]);
+				face[distanceFace0 > 0.0f ? 0 : 1] = face[0] + alpha * (face[1] - face[0]);
 				++outIndex;
 			}
 
-			face[0] = out[0];
-			face[1] = out[1];
-
 			return outIndex;
 		}
 		
@@ -146,6 +138,13 @@ namespace Vivium {
 			F32x2 referenceFaceVertex0 = applyTransform(reference->vertices[referenceManifold->edgeIndex], *referenceTransform);
 			F32x2 referenceFaceVertex1 = applyTransform(reference->vertices[referenceManifold->edgeIndex == reference->vertices.size() - 1 ? 0 : referenceManifold->edgeIndex + 1], *referenceTransform);
 
+			return _clipContacts(referenceFaceVertex0, referenceFaceVertex1, incidentFace, flip);
+		}
+
+		PenetrationManifold _clipContacts(F32x2 referenceFaceVertex0, F32x2 referenceFaceVertex1, std::array<F32x2, 2> incidentFace, bool flip, uint32_t featureBase)
+		{
+			PenetrationManifold manifold;
+
 			F32x2 referenceFaceVector = F32x2::normalise(referenceFaceVertex1 - referenceFaceVertex0);
 			F32x2 referenceFaceNormal = F32x2::left(referenceFaceVector);
 
@@ -163,14 +162,22 @@ namespace Vivium {
 			float separation = F32x2::dot(referenceFaceNormal, incidentFace[0]) - referenceClipped;
 
 			if (separation <= 0.0f) {
-				manifold.contacts[clippedPoints++] = incidentFace[0];
+				manifold.contacts[clippedPoints] = incidentFace[0];
+				manifold.depths[clippedPoints] = -separation;
+				manifold.features[clippedPoints] = featureBase;
+				++clippedPoints;
+
 				manifold.depth = -separation;
 			}
 
 			separation = F32x2::dot(referenceFaceNormal, incidentFace[1]) - referenceClipped;
 
 			if (separation <= 0.0f) {
-				manifold.contacts[clippedPoints++] = incidentFace[1];
+				manifold.contacts[clippedPoints] = incidentFace[1];
+				manifold.depths[clippedPoints] = -separation;
+				manifold.features[clippedPoints] = featureBase | 1;
+				++clippedPoints;
+
 				manifold.depth += -separation;
 				manifold.depth /= static_cast<float>(clippedPoints);
 			}
@@ -180,17 +187,113 @@ namespace Vivium {
 			return manifold;
 		}
 		
+		EdgeManifold axisOfLeastPenetration(WorldPolygon const& a, WorldPolygon const& b)
+		{
+			// As for model space polygons, without moving anything between spaces
+			float maximumDistance = std::numeric_limits<float>::lowest();
+			uint64_t maximumIndex = 0;
+
+			for (uint64_t i = 0; i < a.vertices.size(); i++) {
+				F32x2 normal = a.normals[i];
+				F32x2 support = supportPoints(b.vertices, -normal);
+
+				float penetrationDistance = F32x2::dot(normal, support - a.vertices[i]);
+
+				if (penetrationDistance > maximumDistance) {
+					maximumDistance = penetrationDistance;
+					maximumIndex = i;
+				}
+			}
+
+			return EdgeManifold{ maximumIndex, maximumDistance };
+		}
+
+		uint64_t _incidentFaceIndex(WorldPolygon const& reference, WorldPolygon const& incident, uint64_t referenceIndex)
+		{
+			F32x2 referenceNormal = reference.normals[referenceIndex];
+
+			float minimumProjection = std::numeric_limits<float>::max();
+			uint64_t minimumIndex = 0;
+
+			for (uint64_t i = 0; i < incident.vertices.size(); i++) {
+				float dot = F32x2::dot(referenceNormal, incident.normals[i]);
+
+				if (dot < minimumProjection) {
+					minimumProjection = dot;
+					minimumIndex = i;
+				}
+			}
+
+			return minimumIndex;
+		}
+
+		std::array<F32x2, 2> getIncidentFace(WorldPolygon const& reference, WorldPolygon const& incident, uint64_t referenceIndex)
+		{
+			uint64_t minimumIndex = _incidentFaceIndex(reference, incident, referenceIndex);
+
+			return std::array<F32x2, 2>{
+				incident.vertices[minimumIndex],
+				incident.vertices[minimumIndex == incident.vertices.size() - 1 ? 0 : minimumIndex + 1]
+			};
+		}
+
+		PenetrationManifold polygonToPolygon(WorldPolygon const& a, WorldPolygon const& b)
+		{
+			EdgeManifold edgeA = axisOfLeastPenetration(a, b);
+
+			if (edgeA.depth >= 0.0f) return PenetrationManifold();
+
+			EdgeManifold edgeB = axisOfLeastPenetration(b, a);
+
+			if (edgeB.depth >= 0.0f) return PenetrationManifold();
+
+			// Same bias as the model space version
+			bool flip = !(edgeA.depth >= edgeB.depth * 0.95f + edgeA.depth * 0.01f);
+
+			WorldPolygon const& reference = flip ? b : a;
+			WorldPolygon const& incident = flip ? a : b;
+			uint64_t referenceIndex = flip ? edgeB.edgeIndex : edgeA.edgeIndex;
+
+			uint64_t incidentIndex = _incidentFaceIndex(reference, incident, referenceIndex);
+
+			std::array<F32x2, 2> incidentFace = {
+				incident.vertices[incidentIndex],
+				incident.vertices[incidentIndex == incident.vertices.size() - 1 ? 0 : incidentIndex + 1]
+			};
+
+			uint32_t featureBase = (static_cast<uint32_t>(referenceIndex) << 16) | (static_cast<uint32_t>(incidentIndex) << 2) | (flip ? 2 : 0);
+
+			return _clipContacts(
+				reference.vertices[referenceIndex],
+				reference.vertices[referenceIndex == reference.vertices.size() - 1 ? 0 : referenceIndex + 1],
+				incidentFace,
+				flip,
+				featureBase
+			);
+		}
+
+		AABB shapeBounds(Shape const& shape, F32x2 position)
+		{
+			F32x2 min = shape.getMin();
+			F32x2 max = shape.getMax();
+
+			// Bounds any rotation of the shape about its origin
+			float radius = F32x2::length(F32x2(std::max(std::abs(min.x), std::abs(max.x)), std::max(std::abs(min.y), std::abs(max.y))));
+
+			return AABB{ position - F32x2(radius), position + F32x2(radius) };
+		}
+
+		AABB bodyBounds(Body const& body)
+		{
+			return shapeBounds(body.shape, body.position);
+		}
+
 		bool broadCollisionCheck(Body const& a, Body const& b)
 		{
 			// If either is disabled, they are not colliding
 			if ((!a.enabled) || (!b.enabled)) return false;
 
-			return AABBIntersectAABB(
-				a.shape.getMin() + a.position,
-				a.shape.getMax() + a.position,
-				b.shape.getMin() + b.position,
-				b.shape.getMax() + b.position
-			);
+			return bodyBounds(a).intersects(bodyBounds(b));
 		}
 
 		void checkCollisionAndResolve(Body& a, Body& b)
@@ -218,6 +321,11 @@ namespace Vivium {
 
 			if (manifold.contactCount == 0) return;
 
+			resolveCollision(a, b, manifold);
+		}
+
+		void resolveCollision(Body& a, Body& b, PenetrationManifold const& manifold)
+		{
 			// If they both have infinite mass, set velocity to 0 and exit
 			if (a.inverseMass == 0.0f && b.inverseMass == 0.0f) {
 				a.velocity = b.velocity = F32x2(0.0f);
@@ -249,8 +357,8 @@ namespace Vivium {
 				// Relative velocity in direction of collision normal
 				float velocityLength = F32x2::dot(relativeVelocity, manifold.vector);
 
-				// If moving away, don't bother resolving collision
-				if (velocityLength > 0.0f) return;
+				// If moving away at this contact, don't bother resolving it
+				if (velocityLength > 0.0f) continue;
 
 				float velocityLengthA = F32x2::cross(contactA, manifold.vector);
 				float velocityLengthB = F32x2::cross(contactB, manifold.vector);
@@ -290,7 +398,7 @@ namespace Vivium {
 
 				// If friction small, ignore
 				// TODO: turn into constant EPSILON
-				if (std::abs(frictionLength) < 0.0001f) return;
+				if (std::abs(frictionLength) < 0.0001f) continue;
 
 				F32x2 frictionImpulse;
 				// Coulomb's law
@@ -326,13 +434,26 @@ namespace Vivium {
 		
 		void solve(std::span<Body*> a, std::span<Body*> b)
 		{
-			for (uint64_t i = 0; i < a.size(); i++) {
-				// Start at i + 1 if intragroup, otherwise start at 0 for intergroup
-				uint64_t startIndex = a.data() == b.data() ? i + 1 : 0;
+			bool intragroup = a.data() == b.data();
 
-				for (uint64_t j = startIndex; j < b.size(); j++) {
-					checkCollisionAndResolve(*a[i], *b[j]);
-				}
+			std::vector<Body*> bodies(a.begin(), a.end());
+
+			if (!intragroup) bodies.insert(bodies.end(), b.begin(), b.end());
+
+			std::vector<AABB> bounds(bodies.size());
+
+			for (uint64_t i = 0; i < bodies.size(); i++) {
+				bounds[i] = bodyBounds(*bodies[i]);
+			}
+
+			SweepAndPrune broadphase;
+			broadphase.update(bounds);
+
+			for (BodyPair pair : broadphase.findPairs()) {
+				// Intergroup only resolves pairs with a body from each group, pair.a is always the one from a
+				if (!intragroup && (pair.a < a.size()) == (pair.b < a.size())) continue;
+
+				checkCollisionAndResolve(*bodies[pair.a], *bodies[pair.b]);
 			}
 		}
 		
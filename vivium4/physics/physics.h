@@ -6,6 +6,7 @@
 #include "../math/vec2.h"
 #include "../math/aabb.h"
 #include "body.h"
+#include "broadphase.h"
 #include "material.h"
 #include "shape.h"
 #include "../math/transform.h"
@@ -18,10 +19,15 @@ namespace Vivium {
 		inline constexpr int MAX_CONTACT_COUNT = 2;
 
 		struct PenetrationManifold {
+			// Average of the contact depths
 			float depth;
 			F32x2 vector;
 
 			std::array<F32x2, MAX_CONTACT_COUNT> contacts;
+			std::array<float, MAX_CONTACT_COUNT> depths;
+			// Reference face, incident face, and incident vertex each contact came from, so it can be matched
+			//	with the same contact in the next step
+			std::array<uint32_t, MAX_CONTACT_COUNT> features;
 			uint64_t contactCount;
 
 			PenetrationManifold();
@@ -45,14 +51,53 @@ namespace Vivium {
 		// Which in turn is based on: https://gdcvault.com/play/1017646/Physics-for-Game-Programmers-The
 		// An advancement on the typical SAT method of projecting polygon extents onto each other for each axis
 		PenetrationManifold polygonToPolygon(const Polygon& a, const Polygon& b, const Transform& aTransform, const Transform& bTransform);
+		// Contacts and depth from the reference face, and the incident face clipped to it
+		// Contact features are featureBase, with the index of the incident vertex in the low bit
+		PenetrationManifold _clipContacts(F32x2 referenceFaceVertex0, F32x2 referenceFaceVertex1, std::array<F32x2, 2> incidentFace, bool flip, uint32_t featureBase = 0);
+
+		// Polygon already in world space, as cached by PhysicsWorld once per step
+		// The narrow phase on these does no transforms, so costs the same however many pairs a body is in
+		struct WorldPolygon {
+			std::span<const F32x2> vertices;
+			std::span<const F32x2> normals;
+		};
+
+		EdgeManifold axisOfLeastPenetration(WorldPolygon const& a, WorldPolygon const& b);
+		uint64_t _incidentFaceIndex(WorldPolygon const& reference, WorldPolygon const& incident, uint64_t referenceIndex);
+		std::array<F32x2, 2> getIncidentFace(WorldPolygon const& reference, WorldPolygon const& incident, uint64_t referenceIndex);
+		PenetrationManifold polygonToPolygon(WorldPolygon const& a, WorldPolygon const& b);
 	
+		// World space bounds of the shape at any angle about position, from the furthest corner of its bounds
+		AABB shapeBounds(Shape const& shape, F32x2 position);
+		AABB bodyBounds(Body const& body);
 		// Returns if two body AABBs are intersecting (broad phase collision check)
 		bool broadCollisionCheck(Body const& a, Body const& b);
 		// Check if two objects are colliding (narrow AND broad!), if so, resolve the collision
 		void checkCollisionAndResolve(Body& a, Body& b);
+		// Applies the impulses and positional correction for a manifold with contacts
+		void resolveCollision(Body& a, Body& b, PenetrationManifold const& manifold);
 		// Solve all collisions between two groups of bodies
+		// Candidate pairs come from a sweep and prune over both groups, for solving the same bodies every step,
+		//	keep a broadphase and use the overload below
 		void solve(std::span<Body*> a, std::span<Body*> b);
 
+		// Solve all collisions between bodies, only checking the pairs found by broadphase
+		// Bodies are identified by their index in the span, so should keep their order between steps
+		template <Broadphase BroadphaseType>
+		void solve(std::span<Body*> bodies, BroadphaseType& broadphase) {
+			std::vector<AABB> bounds(bodies.size());
+
+			for (uint64_t i = 0; i < bodies.size(); i++) {
+				bounds[i] = bodyBounds(*bodies[i]);
+			}
+
+			broadphase.update(bounds);
+
+			for (BodyPair pair : broadphase.findPairs()) {
+				checkCollisionAndResolve(*bodies[pair.a], *bodies[pair.b]);
+			}
+		}
+
 		// TODO: automatic way to update bodies? pretty easy to forget
 		void update(Body& body, float deltaTime);
 	}
@@ -0,0 +1,719 @@
+#include "world.h"
+#include "../math/simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace Vivium {
+	namespace Physics {
+		uint64_t ContactManifold::key() const
+		{
+			return makeKey(handleA, handleB);
+		}
+
+		uint64_t ContactManifold::makeKey(BodyHandle a, BodyHandle b)
+		{
+			return (static_cast<uint64_t>(a) << 32) | b;
+		}
+
+		BodyHandle PhysicsWorld::add(Body const& body)
+		{
+			uint32_t index = size();
+
+			positionX.push_back(0.0f); positionY.push_back(0.0f);
+			velocityX.push_back(0.0f); velocityY.push_back(0.0f);
+			forceX.push_back(0.0f); forceY.push_back(0.0f);
+			angle.push_back(0.0f); angularVelocity.push_back(0.0f); torque.push_back(0.0f);
+			inverseMass.push_back(0.0f); inverseInertia.push_back(0.0f);
+			previousPositionX.push_back(body.position.x); previousPositionY.push_back(body.position.y); previousAngle.push_back(body.angle);
+			sleepTime.push_back(0.0f);
+			shapes.emplace_back();
+			materials.emplace_back();
+			enabled.push_back(0);
+
+			_scatter(index, body);
+
+			BodyHandle handle;
+
+			if (freeHandle != nullIndex) {
+				handle = freeHandle;
+				freeHandle = handleIndices[handle];
+				handleIndices[handle] = index;
+			}
+			else {
+				handle = static_cast<BodyHandle>(handleIndices.size());
+				handleIndices.push_back(index);
+			}
+
+			indexHandles.push_back(handle);
+
+			if (body.inverseMass != 0.0f) {
+				_swap(index, dynamicCount++);
+				_swap(dynamicCount - 1, awakeCount++);
+			}
+
+			return handle;
+		}
+
+		void PhysicsWorld::remove(BodyHandle handle)
+		{
+			if (!valid(handle)) {
+				VIVIUM_LOG(LogSeverity::FATAL, "Removed invalid body {}", handle);
+
+				return;
+			}
+
+			_wakeContacts(handle);
+
+			// Its contacts would otherwise warm start whichever body reuses the handle
+			std::erase_if(manifolds, [handle](ContactManifold const& manifold) {
+				return manifold.handleA == handle || manifold.handleB == handle;
+			});
+
+			uint32_t index = handleIndices[handle];
+
+			// Move out of the awake range, then out of the sleeping range, then to the back
+			if (index < awakeCount) {
+				_swap(index, awakeCount - 1);
+				index = --awakeCount;
+			}
+
+			if (index < dynamicCount) {
+				_swap(index, dynamicCount - 1);
+				index = --dynamicCount;
+			}
+
+			_swap(index, size() - 1);
+
+			positionX.pop_back(); positionY.pop_back();
+			velocityX.pop_back(); velocityY.pop_back();
+			forceX.pop_back(); forceY.pop_back();
+			angle.pop_back(); angularVelocity.pop_back(); torque.pop_back();
+			inverseMass.pop_back(); inverseInertia.pop_back();
+			previousPositionX.pop_back(); previousPositionY.pop_back(); previousAngle.pop_back();
+			sleepTime.pop_back();
+			shapes.pop_back();
+			materials.pop_back();
+			enabled.pop_back();
+			indexHandles.pop_back();
+
+			handleIndices[handle] = freeHandle;
+			freeHandle = handle;
+		}
+
+		bool PhysicsWorld::valid(BodyHandle handle) const
+		{
+			return handle < handleIndices.size() && handleIndices[handle] < size() && indexHandles[handleIndices[handle]] == handle;
+		}
+
+		Body PhysicsWorld::get(BodyHandle handle) const
+		{
+			return _gather(handleIndices[handle]);
+		}
+
+		void PhysicsWorld::set(BodyHandle handle, Body const& body)
+		{
+			wake(handle);
+			_wakeContacts(handle);
+
+			uint32_t index = handleIndices[handle];
+
+			bool wasDynamic = index < dynamicCount;
+			bool isDynamic = body.inverseMass != 0.0f;
+
+			_scatter(index, body);
+
+			if (wasDynamic && !isDynamic) {
+				_swap(index, --awakeCount);
+				_swap(awakeCount, --dynamicCount);
+			}
+			else if (!wasDynamic && isDynamic) {
+				_swap(index, dynamicCount++);
+				_swap(dynamicCount - 1, awakeCount++);
+			}
+		}
+
+		void PhysicsWorld::addForce(BodyHandle handle, F32x2 force)
+		{
+			uint32_t index = handleIndices[handle];
+
+			forceX[index] += force.x;
+			forceY[index] += force.y;
+		}
+
+		void PhysicsWorld::addTorque(BodyHandle handle, float addedTorque)
+		{
+			torque[handleIndices[handle]] += addedTorque;
+		}
+
+		bool PhysicsWorld::isAwake(BodyHandle handle) const
+		{
+			return handleIndices[handle] < awakeCount;
+		}
+
+		void PhysicsWorld::wake(BodyHandle handle)
+		{
+			uint32_t index = handleIndices[handle];
+
+			if (index >= dynamicCount) return;
+
+			if (index >= awakeCount) _wake(index);
+			// Keeps the island awake, if the body already was
+			else sleepTime[index] = 0.0f;
+		}
+
+		void PhysicsWorld::_wakeContacts(BodyHandle handle)
+		{
+			// Indices in the manifolds may be stale since the last step, handles aren't
+			for (ContactManifold const& manifold : manifolds) {
+				if (manifold.handleA == handle && valid(manifold.handleB)) wake(manifold.handleB);
+				else if (manifold.handleB == handle && valid(manifold.handleA)) wake(manifold.handleA);
+			}
+		}
+
+		F32x2 PhysicsWorld::getPosition(BodyHandle handle) const
+		{
+			uint32_t index = handleIndices[handle];
+
+			return F32x2(positionX[index], positionY[index]);
+		}
+
+		F32x2 PhysicsWorld::getVelocity(BodyHandle handle) const
+		{
+			uint32_t index = handleIndices[handle];
+
+			return F32x2(velocityX[index], velocityY[index]);
+		}
+
+		float PhysicsWorld::getAngle(BodyHandle handle) const
+		{
+			return angle[handleIndices[handle]];
+		}
+
+		uint32_t PhysicsWorld::size() const
+		{
+			return static_cast<uint32_t>(positionX.size());
+		}
+
+		void PhysicsWorld::step(float deltaTime)
+		{
+			_substep(deltaTime);
+			clearForces();
+		}
+
+		uint32_t PhysicsWorld::advance(float frameDeltaTime)
+		{
+			accumulator += frameDeltaTime;
+
+			uint32_t substeps = 0;
+
+			while (accumulator >= fixedDeltaTime && substeps < maxSubsteps) {
+				previousPositionX.assign(positionX.begin(), positionX.end());
+				previousPositionY.assign(positionY.begin(), positionY.end());
+				previousAngle.assign(angle.begin(), angle.end());
+
+				_substep(fixedDeltaTime);
+
+				accumulator -= fixedDeltaTime;
+				++substeps;
+			}
+
+			// Drop whole steps past the cap, keeping the fraction for interpolation
+			if (accumulator >= fixedDeltaTime) accumulator = std::fmod(accumulator, fixedDeltaTime);
+
+			// Forces are rates held over this frame, not impulses to save for a frame that steps
+			clearForces();
+
+			return substeps;
+		}
+
+		float PhysicsWorld::interpolationAlpha() const
+		{
+			return accumulator / fixedDeltaTime;
+		}
+
+		F32x2 PhysicsWorld::getInterpolatedPosition(BodyHandle handle) const
+		{
+			uint32_t index = handleIndices[handle];
+			float alpha = interpolationAlpha();
+
+			return F32x2(
+				previousPositionX[index] + (positionX[index] - previousPositionX[index]) * alpha,
+				previousPositionY[index] + (positionY[index] - previousPositionY[index]) * alpha
+			);
+		}
+
+		float PhysicsWorld::getInterpolatedAngle(BodyHandle handle) const
+		{
+			uint32_t index = handleIndices[handle];
+
+			return previousAngle[index] + (angle[index] - previousAngle[index]) * interpolationAlpha();
+		}
+
+		void PhysicsWorld::_substep(float deltaTime)
+		{
+			collide();
+			integrateVelocities(deltaTime);
+			solveContacts(deltaTime);
+			integratePositions(deltaTime);
+			updateSleeping(deltaTime);
+		}
+
+		void PhysicsWorld::collide()
+		{
+			_cacheTransforms();
+
+			// Pairs only change when a body leaves its fattened bounds, which most substeps don't
+			std::span<const BodyPair> pairs = broadphase.update(bounds) ? broadphase.findPairs() : broadphase.pairs;
+
+			std::swap(manifolds, previousManifolds);
+			manifolds.clear();
+
+			for (BodyPair pair : pairs) {
+				// Static bodies never collide with each other
+				if (pair.a >= dynamicCount && pair.b >= dynamicCount) continue;
+				if (!enabled[pair.a] || !enabled[pair.b]) continue;
+				// Tree pairs are of fattened bounds
+				if (!bounds[pair.a].intersects(bounds[pair.b])) continue;
+
+				uint32_t indexA = pair.a;
+				uint32_t indexB = pair.b;
+
+				if (indexHandles[indexA] > indexHandles[indexB]) std::swap(indexA, indexB);
+
+				// Neither body has moved, so their contacts haven't changed, and are kept to hold the island together
+				if (indexA >= awakeCount && indexB >= awakeCount) {
+					ContactManifold const* previous = _previousManifold(ContactManifold::makeKey(indexHandles[indexA], indexHandles[indexB]));
+
+					if (previous == nullptr) continue;
+
+					ContactManifold& manifold = manifolds.emplace_back(*previous);
+					manifold.indexA = indexA;
+					manifold.indexB = indexB;
+
+					continue;
+				}
+
+				PenetrationManifold penetration = polygonToPolygon(_worldPolygon(indexA), _worldPolygon(indexB));
+
+				if (penetration.contactCount == 0) continue;
+
+				ContactManifold& manifold = manifolds.emplace_back();
+				manifold.handleA = indexHandles[indexA];
+				manifold.handleB = indexHandles[indexB];
+				manifold.indexA = indexA;
+				manifold.indexB = indexB;
+				manifold.normal = penetration.vector;
+				// Same mixing as resolveCollision
+				manifold.friction = std::sqrt(materials[indexA].staticFriction * materials[indexB].staticFriction);
+				manifold.restitution = materials[indexA].restitution * materials[indexB].restitution;
+				manifold.contactCount = static_cast<uint32_t>(penetration.contactCount);
+
+				for (uint32_t i = 0; i < manifold.contactCount; i++) {
+					ContactPoint& point = manifold.points[i];
+					point = ContactPoint{};
+					point.position = penetration.contacts[i];
+					point.depth = penetration.depths[i];
+					point.feature = penetration.features[i];
+				}
+			}
+
+			std::sort(manifolds.begin(), manifolds.end(), [](ContactManifold const& a, ContactManifold const& b) {
+				return a.key() < b.key();
+			});
+
+			if (!warmStarting) return;
+
+			for (ContactManifold& manifold : manifolds) {
+				ContactManifold const* previous = _previousManifold(manifold.key());
+
+				if (previous == nullptr) continue;
+
+				for (uint32_t i = 0; i < manifold.contactCount; i++) {
+					for (uint32_t j = 0; j < previous->contactCount; j++) {
+						if (manifold.points[i].feature != previous->points[j].feature) continue;
+
+						manifold.points[i].normalImpulse = previous->points[j].normalImpulse;
+						manifold.points[i].tangentImpulse = previous->points[j].tangentImpulse;
+
+						break;
+					}
+				}
+			}
+		}
+
+		void PhysicsWorld::solveContacts(float deltaTime)
+		{
+			float inverseDeltaTime = deltaTime > 0.0f ? 1.0f / deltaTime : 0.0f;
+
+			for (ContactManifold& manifold : manifolds) {
+				if (_asleep(manifold)) continue;
+
+				uint32_t a = manifold.indexA;
+				uint32_t b = manifold.indexB;
+
+				// A sleeping body isn't integrated this step, so is held still until its island wakes
+				manifold.inverseMassA = a < awakeCount ? inverseMass[a] : 0.0f;
+				manifold.inverseMassB = b < awakeCount ? inverseMass[b] : 0.0f;
+				manifold.inverseInertiaA = a < awakeCount ? inverseInertia[a] : 0.0f;
+				manifold.inverseInertiaB = b < awakeCount ? inverseInertia[b] : 0.0f;
+
+				F32x2 tangent = F32x2::right(manifold.normal);
+
+				for (uint32_t i = 0; i < manifold.contactCount; i++) {
+					ContactPoint& point = manifold.points[i];
+
+					point.offsetA = point.position - F32x2(positionX[a], positionY[a]);
+					point.offsetB = point.position - F32x2(positionX[b], positionY[b]);
+
+					float normalA = F32x2::cross(point.offsetA, manifold.normal);
+					float normalB = F32x2::cross(point.offsetB, manifold.normal);
+					float tangentA = F32x2::cross(point.offsetA, tangent);
+					float tangentB = F32x2::cross(point.offsetB, tangent);
+
+					float inverseMassSum = manifold.inverseMassA + manifold.inverseMassB;
+
+					point.normalMass = 1.0f / (inverseMassSum + normalA * normalA * manifold.inverseInertiaA + normalB * normalB * manifold.inverseInertiaB);
+					point.tangentMass = 1.0f / (inverseMassSum + tangentA * tangentA * manifold.inverseInertiaA + tangentB * tangentB * manifold.inverseInertiaB);
+
+					point.bias = baumgarte * inverseDeltaTime * std::max(point.depth - penetrationSlop, 0.0f);
+
+					float approach = F32x2::dot(_relativeVelocity(manifold, point), manifold.normal);
+
+					if (approach < -restitutionThreshold) {
+						point.bias = std::max(point.bias, -manifold.restitution * approach);
+					}
+				}
+			}
+
+			// After every bias is found, so restitution only sees the velocity bodies arrived with
+			for (ContactManifold const& manifold : manifolds) {
+				if (_asleep(manifold)) continue;
+
+				F32x2 tangent = F32x2::right(manifold.normal);
+
+				for (uint32_t i = 0; i < manifold.contactCount; i++) {
+					ContactPoint const& point = manifold.points[i];
+
+					_applyImpulse(manifold, point, manifold.normal * point.normalImpulse + tangent * point.tangentImpulse);
+				}
+			}
+
+			for (uint32_t iteration = 0; iteration < velocityIterations; iteration++) {
+				for (ContactManifold& manifold : manifolds) {
+					if (_asleep(manifold)) continue;
+
+					F32x2 tangent = F32x2::right(manifold.normal);
+
+					for (uint32_t i = 0; i < manifold.contactCount; i++) {
+						ContactPoint& point = manifold.points[i];
+
+						// Contacts only push, so the accumulated normal impulse stays positive
+						float approach = F32x2::dot(_relativeVelocity(manifold, point), manifold.normal);
+						float normalImpulse = std::max(point.normalImpulse + point.normalMass * (point.bias - approach), 0.0f);
+						float normalChange = normalImpulse - point.normalImpulse;
+						point.normalImpulse = normalImpulse;
+
+						_applyImpulse(manifold, point, manifold.normal * normalChange);
+
+						// Coulomb's law, friction is bounded by the normal impulse
+						float slide = F32x2::dot(_relativeVelocity(manifold, point), tangent);
+						float maximumFriction = manifold.friction * point.normalImpulse;
+						float tangentImpulse = std::clamp(point.tangentImpulse - point.tangentMass * slide, -maximumFriction, maximumFriction);
+						float tangentChange = tangentImpulse - point.tangentImpulse;
+						point.tangentImpulse = tangentImpulse;
+
+						_applyImpulse(manifold, point, tangent * tangentChange);
+					}
+				}
+			}
+		}
+
+		void PhysicsWorld::updateSleeping(float deltaTime)
+		{
+			if (!allowSleeping) {
+				while (awakeCount < dynamicCount) _wake(awakeCount);
+
+				return;
+			}
+
+			float linearSquared = sleepLinearVelocity * sleepLinearVelocity;
+			float angularSquared = sleepAngularVelocity * sleepAngularVelocity;
+
+			for (uint32_t i = 0; i < awakeCount; i++) {
+				bool slow = velocityX[i] * velocityX[i] + velocityY[i] * velocityY[i] <= linearSquared
+					&& angularVelocity[i] * angularVelocity[i] <= angularSquared;
+
+				sleepTime[i] = slow ? sleepTime[i] + deltaTime : 0.0f;
+			}
+
+			islandParents.resize(dynamicCount);
+			std::iota(islandParents.begin(), islandParents.end(), 0);
+
+			// Static bodies don't join islands, a pile on the ground can sleep apart from the rest of the level
+			for (ContactManifold const& manifold : manifolds) {
+				if (manifold.indexA >= dynamicCount || manifold.indexB >= dynamicCount) continue;
+
+				islandParents[_findIsland(manifold.indexA)] = _findIsland(manifold.indexB);
+			}
+
+			islandSleepTimes.assign(dynamicCount, std::numeric_limits<float>::max());
+
+			for (uint32_t i = 0; i < dynamicCount; i++) {
+				float& islandSleepTime = islandSleepTimes[_findIsland(i)];
+				islandSleepTime = std::min(islandSleepTime, sleepTime[i]);
+			}
+
+			// Moving bodies changes their indices, so collect them first
+			sleepingHandles.clear();
+			wakingHandles.clear();
+
+			for (uint32_t i = 0; i < dynamicCount; i++) {
+				bool islandSleeps = islandSleepTimes[_findIsland(i)] >= timeToSleep;
+
+				if (i < awakeCount && islandSleeps) sleepingHandles.push_back(indexHandles[i]);
+				else if (i >= awakeCount && !islandSleeps) wakingHandles.push_back(indexHandles[i]);
+			}
+
+			for (BodyHandle handle : sleepingHandles) _sleep(handleIndices[handle]);
+			for (BodyHandle handle : wakingHandles) _wake(handleIndices[handle]);
+		}
+
+		ContactManifold const* PhysicsWorld::_previousManifold(uint64_t key) const
+		{
+			auto it = std::lower_bound(previousManifolds.begin(), previousManifolds.end(), key, [](ContactManifold const& manifold, uint64_t key) {
+				return manifold.key() < key;
+			});
+
+			if (it == previousManifolds.end() || it->key() != key) return nullptr;
+
+			return &*it;
+		}
+
+		bool PhysicsWorld::_asleep(ContactManifold const& manifold) const
+		{
+			return manifold.indexA >= awakeCount && manifold.indexB >= awakeCount;
+		}
+
+		uint32_t PhysicsWorld::_findIsland(uint32_t index)
+		{
+			// Path halving
+			while (islandParents[index] != index) {
+				islandParents[index] = islandParents[islandParents[index]];
+				index = islandParents[index];
+			}
+
+			return index;
+		}
+
+		void PhysicsWorld::_sleep(uint32_t index)
+		{
+			_swap(index, --awakeCount);
+
+			velocityX[awakeCount] = velocityY[awakeCount] = angularVelocity[awakeCount] = 0.0f;
+		}
+
+		void PhysicsWorld::_wake(uint32_t index)
+		{
+			_swap(index, awakeCount);
+
+			sleepTime[awakeCount++] = 0.0f;
+		}
+
+		void PhysicsWorld::_applyImpulse(ContactManifold const& manifold, ContactPoint const& point, F32x2 impulse)
+		{
+			uint32_t a = manifold.indexA;
+			uint32_t b = manifold.indexB;
+
+			velocityX[a] -= manifold.inverseMassA * impulse.x;
+			velocityY[a] -= manifold.inverseMassA * impulse.y;
+			angularVelocity[a] -= manifold.inverseInertiaA * F32x2::cross(point.offsetA, impulse);
+
+			velocityX[b] += manifold.inverseMassB * impulse.x;
+			velocityY[b] += manifold.inverseMassB * impulse.y;
+			angularVelocity[b] += manifold.inverseInertiaB * F32x2::cross(point.offsetB, impulse);
+		}
+
+		F32x2 PhysicsWorld::_relativeVelocity(ContactManifold const& manifold, ContactPoint const& point) const
+		{
+			uint32_t a = manifold.indexA;
+			uint32_t b = manifold.indexB;
+
+			return F32x2(velocityX[b], velocityY[b]) + F32x2::right(point.offsetB) * angularVelocity[b]
+				- F32x2(velocityX[a], velocityY[a]) - F32x2::right(point.offsetA) * angularVelocity[a];
+		}
+
+		void PhysicsWorld::_cacheTransforms()
+		{
+			uint32_t count = size();
+
+			transforms.resize(count);
+			bounds.resize(count);
+			vertexOffsets.resize(count + 1);
+
+			uint32_t vertexCount = 0;
+
+			for (uint32_t i = 0; i < count; i++) {
+				vertexOffsets[i] = vertexCount;
+				vertexCount += static_cast<uint32_t>(reinterpret_cast<const Polygon*>(shapes[i].shape)->vertices.size());
+			}
+
+			vertexOffsets[count] = vertexCount;
+
+			worldVertices.resize(vertexCount);
+			worldNormals.resize(vertexCount);
+
+			for (uint32_t i = 0; i < count; i++) {
+				Transform& transform = transforms[i];
+				transform.position = F32x2(positionX[i], positionY[i]);
+				transform.rotation = Mat2x2::fromAngle(angle[i]);
+				transform.rotationInverse = transform.rotation.transpose();
+
+				const Polygon* polygon = reinterpret_cast<const Polygon*>(shapes[i].shape);
+
+				F32x2 min = F32x2::inf();
+				F32x2 max = -F32x2::inf();
+
+				for (uint32_t j = 0; j < polygon->vertices.size(); j++) {
+					F32x2 vertex = applyTransform(polygon->vertices[j], transform);
+
+					worldVertices[vertexOffsets[i] + j] = vertex;
+					worldNormals[vertexOffsets[i] + j] = transform.rotation * polygon->normals[j];
+
+					min = F32x2(std::min(min.x, vertex.x), std::min(min.y, vertex.y));
+					max = F32x2(std::max(max.x, vertex.x), std::max(max.y, vertex.y));
+				}
+
+				// Exact bounds at the current angle
+				bounds[i] = AABB{ min, max };
+			}
+		}
+
+		WorldPolygon PhysicsWorld::_worldPolygon(uint32_t index) const
+		{
+			uint32_t offset = vertexOffsets[index];
+			uint32_t count = vertexOffsets[index + 1] - offset;
+
+			return WorldPolygon{
+				std::span<const F32x2>(worldVertices.data() + offset, count),
+				std::span<const F32x2>(worldNormals.data() + offset, count)
+			};
+		}
+
+		void PhysicsWorld::integrate(float deltaTime)
+		{
+			integrateVelocities(deltaTime);
+			integratePositions(deltaTime);
+			clearForces();
+		}
+
+		void PhysicsWorld::integrateVelocities(float deltaTime)
+		{
+			// Same integration as Physics::update, Simd::width bodies at a time
+			Simd::Floats lanesDeltaTime = Simd::broadcast(deltaTime);
+
+			uint64_t i = 0;
+
+			for (; i + Simd::width <= awakeCount; i += Simd::width) {
+				Simd::Floats lanesInverseMass = Simd::mul(Simd::load(&inverseMass[i]), lanesDeltaTime);
+				Simd::Floats lanesInverseInertia = Simd::mul(Simd::load(&inverseInertia[i]), lanesDeltaTime);
+
+				Simd::store(&velocityX[i], Simd::add(Simd::load(&velocityX[i]), Simd::mul(Simd::load(&forceX[i]), lanesInverseMass)));
+				Simd::store(&velocityY[i], Simd::add(Simd::load(&velocityY[i]), Simd::mul(Simd::load(&forceY[i]), lanesInverseMass)));
+				Simd::store(&angularVelocity[i], Simd::add(Simd::load(&angularVelocity[i]), Simd::mul(Simd::load(&torque[i]), lanesInverseInertia)));
+			}
+
+			for (; i < awakeCount; i++) {
+				velocityX[i] += forceX[i] * (inverseMass[i] * deltaTime);
+				velocityY[i] += forceY[i] * (inverseMass[i] * deltaTime);
+				angularVelocity[i] += torque[i] * (inverseInertia[i] * deltaTime);
+			}
+		}
+
+		void PhysicsWorld::clearForces()
+		{
+			std::fill(forceX.begin(), forceX.begin() + dynamicCount, 0.0f);
+			std::fill(forceY.begin(), forceY.begin() + dynamicCount, 0.0f);
+			std::fill(torque.begin(), torque.begin() + dynamicCount, 0.0f);
+		}
+
+		void PhysicsWorld::integratePositions(float deltaTime)
+		{
+			Simd::Floats lanesDeltaTime = Simd::broadcast(deltaTime);
+
+			uint64_t i = 0;
+
+			for (; i + Simd::width <= awakeCount; i += Simd::width) {
+				Simd::store(&positionX[i], Simd::add(Simd::load(&positionX[i]), Simd::mul(Simd::load(&velocityX[i]), lanesDeltaTime)));
+				Simd::store(&positionY[i], Simd::add(Simd::load(&positionY[i]), Simd::mul(Simd::load(&velocityY[i]), lanesDeltaTime)));
+				Simd::store(&angle[i], Simd::add(Simd::load(&angle[i]), Simd::mul(Simd::load(&angularVelocity[i]), lanesDeltaTime)));
+			}
+
+			for (; i < awakeCount; i++) {
+				positionX[i] += velocityX[i] * deltaTime;
+				positionY[i] += velocityY[i] * deltaTime;
+				angle[i] += angularVelocity[i] * deltaTime;
+			}
+		}
+
+		Body PhysicsWorld::_gather(uint32_t index) const
+		{
+			Body body;
+
+			body.position = F32x2(positionX[index], positionY[index]);
+			body.velocity = F32x2(velocityX[index], velocityY[index]);
+			body.force = F32x2(forceX[index], forceY[index]);
+			body.angle = angle[index];
+			body.angularVelocity = angularVelocity[index];
+			body.torque = torque[index];
+			body.inverseInertia = inverseInertia[index];
+			body.inverseMass = inverseMass[index];
+			body.shape = shapes[index];
+			body.material = materials[index];
+			body.enabled = enabled[index] != 0;
+
+			return body;
+		}
+
+		void PhysicsWorld::_scatter(uint32_t index, Body const& body)
+		{
+			positionX[index] = body.position.x;
+			positionY[index] = body.position.y;
+			velocityX[index] = body.velocity.x;
+			velocityY[index] = body.velocity.y;
+			forceX[index] = body.force.x;
+			forceY[index] = body.force.y;
+			angle[index] = body.angle;
+			angularVelocity[index] = body.angularVelocity;
+			torque[index] = body.torque;
+			inverseInertia[index] = body.inverseInertia;
+			inverseMass[index] = body.inverseMass;
+			shapes[index] = body.shape;
+			materials[index] = body.material;
+			enabled[index] = body.enabled;
+			sleepTime[index] = 0.0f;
+		}
+
+		void PhysicsWorld::_swap(uint32_t a, uint32_t b)
+		{
+			if (a == b) return;
+
+			for (std::vector<float>* field : { &positionX, &positionY, &velocityX, &velocityY, &forceX, &forceY,
+				&angle, &angularVelocity, &torque, &inverseMass, &inverseInertia,
+				&previousPositionX, &previousPositionY, &previousAngle, &sleepTime }) {
+				std::swap((*field)[a], (*field)[b]);
+			}
+
+			std::swap(shapes[a], shapes[b]);
+			std::swap(materials[a], materials[b]);
+			std::swap(enabled[a], enabled[b]);
+			std::swap(indexHandles[a], indexHandles[b]);
+
+			handleIndices[indexHandles[a]] = a;
+			handleIndices[indexHandles[b]] = b;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "body.h"
+#include "broadphase.h"
+#include "physics.h"
+#include "../math/aabb.h"
+#include "../math/transform.h"
+#include "../error/log.h"
+
+namespace Vivium {
+	namespace Physics {
+		// Stays valid until the body is removed, unlike the body's index in the world
+		using BodyHandle = uint32_t;
+
+		struct ContactPoint {
+			F32x2 position;
+			float depth;
+			// Matches the contact to the same contact of the previous step, see PenetrationManifold::features
+			uint32_t feature;
+
+			// From the centre of each body to the contact
+			F32x2 offsetA, offsetB;
+			float normalMass, tangentMass;
+			// Velocity the normal impulse aims for, pushing out penetration and adding restitution
+			float bias;
+
+			// Accumulated over the solver iterations, and kept to warm start the next step
+			float normalImpulse, tangentImpulse;
+		};
+
+		// Contacts between a pair of bodies, kept across steps
+		// Ordered by handle so the pair has the same key however their indices move
+		struct ContactManifold {
+			BodyHandle handleA, handleB;
+			// Index of each body in the step the manifold was made in
+			uint32_t indexA, indexB;
+
+			// From A to B
+			F32x2 normal;
+			float friction, restitution;
+			// Of the bodies as the solver sees them, 0 for static and sleeping bodies
+			float inverseMassA, inverseMassB;
+			float inverseInertiaA, inverseInertiaB;
+
+			uint32_t contactCount;
+			std::array<ContactPoint, MAX_CONTACT_COUNT> points;
+
+			uint64_t key() const;
+			static uint64_t makeKey(BodyHandle a, BodyHandle b);
+		};
+
+		// Owns bodies as a structure of arrays, so a step streams through only the fields it uses
+		// Awake dynamic bodies are kept at [0, awakeCount), sleeping dynamic bodies at [awakeCount, dynamicCount),
+		//	and static bodies (inverseMass == 0) after them, so integration runs over a contiguous range with
+		//	no per-body branch
+		struct PhysicsWorld {
+			static constexpr uint32_t nullIndex = UINT32_MAX;
+
+			// Hot, read or written by integration
+			std::vector<float> positionX, positionY;
+			std::vector<float> velocityX, velocityY;
+			std::vector<float> forceX, forceY;
+			std::vector<float> angle, angularVelocity, torque;
+			std::vector<float> inverseMass, inverseInertia;
+
+			// Position and angle before the last fixed step advance() ran, to interpolate from
+			std::vector<float> previousPositionX, previousPositionY, previousAngle;
+
+			// How long each body has been slow enough to sleep
+			std::vector<float> sleepTime;
+
+			// Cold, only read by collision
+			std::vector<Shape> shapes;
+			std::vector<Material> materials;
+			std::vector<uint8_t> enabled;
+
+			uint32_t awakeCount = 0;
+			uint32_t dynamicCount = 0;
+
+			// Index of each handle, free handles form a list through their slots
+			std::vector<uint32_t> handleIndices;
+			std::vector<BodyHandle> indexHandles;
+			BodyHandle freeHandle = nullIndex;
+
+			TreeBroadphase broadphase;
+
+			// Per step scratch, rebuilt at the start of collide() and reused between steps
+			// Every body's transform, bounds, and world space polygon, so the narrow phase doesn't recompute
+			//	them for each pair a body is in
+			std::vector<Transform> transforms;
+			std::vector<AABB> bounds;
+			// Vertices and normals of body i are at [vertexOffsets[i], vertexOffsets[i + 1])
+			std::vector<F32x2> worldVertices;
+			std::vector<F32x2> worldNormals;
+			std::vector<uint32_t> vertexOffsets;
+
+			// Manifolds of this step and the last, sorted by key
+			std::vector<ContactManifold> manifolds;
+			std::vector<ContactManifold> previousManifolds;
+			// Union-find parent of each dynamic body, and the shortest sleep time in each island
+			std::vector<uint32_t> islandParents;
+			std::vector<float> islandSleepTimes;
+			std::vector<BodyHandle> sleepingHandles, wakingHandles;
+
+			// Sequential impulse solver
+			uint32_t velocityIterations = 8;
+			// Starts each contact from the impulses it ended the last step with
+			bool warmStarting = true;
+			// Fraction of the penetration beyond the slop pushed out each step
+			float baumgarte = 0.2f;
+			float penetrationSlop = 0.01f;
+			// Slower approaching contacts don't bounce, so resting contacts settle
+			float restitutionThreshold = 1.0f;
+
+			// Fixed steps run by advance()
+			float fixedDeltaTime = 1.0f / 60.0f;
+			// Time past this many steps in one advance() is dropped, so a slow frame doesn't make the next
+			//	frame slower still
+			uint32_t maxSubsteps = 8;
+			// Frame time not yet stepped
+			float accumulator = 0.0f;
+
+			// Islands, bodies connected through contacts, sleep together once every body in them has been
+			//	slower than these for timeToSleep, and wake together when any of them is woken
+			bool allowSleeping = true;
+			float sleepLinearVelocity = 0.05f;
+			float sleepAngularVelocity = 0.05f;
+			float timeToSleep = 0.5f;
+
+			// Body is copied in, its force and torque are kept for the next step
+			BodyHandle add(Body const& body);
+			// Wakes the bodies touching it, so nothing is left resting on a body that's gone
+			void remove(BodyHandle handle);
+			// If handle refers to a body that hasn't been removed
+			bool valid(BodyHandle handle) const;
+
+			// Copies the body out of the world
+			Body get(BodyHandle handle) const;
+			// Replaces every field of the body, moving it between the dynamic and static ranges if its
+			//	inverse mass changed to or from 0, and waking it and the bodies touching it
+			void set(BodyHandle handle, Body const& body);
+
+			// Forces on sleeping bodies are dropped, wake them to push them
+			void addForce(BodyHandle handle, F32x2 force);
+			void addTorque(BodyHandle handle, float torque);
+
+			// Static bodies are never awake
+			bool isAwake(BodyHandle handle) const;
+			// Wakes the body, and through the next step, the rest of its island
+			void wake(BodyHandle handle);
+
+			F32x2 getPosition(BodyHandle handle) const;
+			F32x2 getVelocity(BodyHandle handle) const;
+			float getAngle(BodyHandle handle) const;
+
+			uint32_t size() const;
+
+			// Finds contacts, integrates forces, solves the contacts, integrates velocities, then puts islands
+			//	to sleep
+			void step(float deltaTime);
+			// Runs as many fixed steps as the frame time adds up to, returns the number run
+			// Forces added before the call act over every step it runs, and are cleared even if none ran
+			uint32_t advance(float frameDeltaTime);
+			// Fraction of a fixed step left in the accumulator, for blending the last two steps when rendering
+			float interpolationAlpha() const;
+			F32x2 getInterpolatedPosition(BodyHandle handle) const;
+			float getInterpolatedAngle(BodyHandle handle) const;
+
+			// Finds candidate pairs through the broadphase and builds their manifolds, carrying impulses
+			//	over from matching contacts of the last step
+			// Pairs with no awake body keep their manifold from the last step, so islands stay connected
+			void collide();
+			// Applies impulses to the velocities until contacts stop approaching
+			void solveContacts(float deltaTime);
+			// Integrates forces and velocities of awake bodies, and clears the forces of dynamic bodies
+			void integrate(float deltaTime);
+			void integrateVelocities(float deltaTime);
+			void integratePositions(float deltaTime);
+			void clearForces();
+
+			// Builds islands from the manifolds, then sleeps or wakes each one
+			void updateSleeping(float deltaTime);
+
+			// step() without clearing forces
+			void _substep(float deltaTime);
+
+			// Fills the per step scratch from the current positions and angles
+			void _cacheTransforms();
+			WorldPolygon _worldPolygon(uint32_t index) const;
+			// Manifold from the last step with the same key, or nullptr
+			ContactManifold const* _previousManifold(uint64_t key) const;
+			void _applyImpulse(ContactManifold const& manifold, ContactPoint const& point, F32x2 impulse);
+			F32x2 _relativeVelocity(ContactManifold const& manifold, ContactPoint const& point) const;
+			// Neither body is awake, so the solver leaves it alone
+			bool _asleep(ContactManifold const& manifold) const;
+			uint32_t _findIsland(uint32_t index);
+			// Wakes every body touching the body, before it's removed or changed
+			void _wakeContacts(BodyHandle handle);
+			// Move the body between the awake and sleeping ranges
+			void _sleep(uint32_t index);
+			void _wake(uint32_t index);
+
+			// Copies body index to a Body, and back
+			Body _gather(uint32_t index) const;
+			void _scatter(uint32_t index, Body const& body);
+			void _swap(uint32_t a, uint32_t b);
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "serialiser.h"
+
+#include <cstring>
+
+namespace Vivium {
+	void SerialiserFileInterface::writeBytes(uint64_t length, void const* data)
+	{
+		file.write(static_cast<char const*>(data), length);
+	}
+
+	void SerialiserFileInterface::readBytes(uint64_t length, void* data)
+	{
+		file.read(static_cast<char*>(data), length);
+	}
+
+	void SerialiserMemoryInterface::writeBytes(uint64_t length, void const* data)
+	{
+		if (length == 0) return;
+
+		std::memcpy(static_cast<uint8_t*>(destination) + offset, data, length);
+
+		offset += length;
+	}
+
+	void SerialiserMemoryInterface::readBytes(uint64_t length, void* data)
+	{
+		if (length == 0) return;
+
+		std::memcpy(data, static_cast<uint8_t const*>(destination) + offset, length);
+
+		offset += length;
+	}
+
+	void SerialiserBufferInterface::writeBytes(uint64_t length, void const* data)
+	{
+		uint8_t const* source = static_cast<uint8_t const*>(data);
+
+		bytes.insert(bytes.end(), source, source + length);
+	}
+
+	void SerialiserBufferInterface::readBytes(uint64_t length, void* data)
+	{
+		if (length == 0) return;
+
+		std::memcpy(data, bytes.data() + readOffset, length);
+
+		readOffset += length;
+	}
+
+	void SerialiserBufferInterface::clear()
+	{
+		bytes.clear();
+		readOffset = 0;
+	}
+}
\ No newline at end of file
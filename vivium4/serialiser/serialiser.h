@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <concepts>
+#include <type_traits>
+#include <vector>
 
 #include <fstream>
 
@@ -21,14 +23,47 @@ namespace Vivium {
 		void readBytes(uint64_t length, void* data);
 	};
 
+	// Growable in-memory store, writes append and reads continue from readOffset
+	// Clearing keeps the allocation, so repeated snapshots (e.g. rollback) don't reallocate
+	struct SerialiserBufferInterface {
+		std::vector<uint8_t> bytes;
+		uint64_t readOffset = 0;
+
+		void writeBytes(uint64_t length, void const* data);
+		void readBytes(uint64_t length, void* data);
+		void clear();
+	};
+
 	template <typename T>
 	concept SerialiserInterface = requires(T interface) {
 		interface.writeBytes(std::declval<uint64_t>(), std::declval<void const*>());
 		interface.readBytes(std::declval<uint64_t>(), std::declval<void*>());
 	};
 
-	template <SerialiserInterface Interface>
-	void serialiseWrite(uint8_t data, Interface store) { store.writeBytes(sizeof(uint8_t), &data); }
-	template <SerialiserInterface Interface>
-	void serialiseRead(uint8_t* data, Interface store) { store.readBytes(sizeof(uint8_t), &data); }
+	// Type-erased SerialiserInterface, for code that can't be templated on the interface
+	//	(e.g. per-component hooks stored in a ComponentManager)
+	// References the interface, which must outlive it
+	struct Serialiser {
+		typedef void(*WriteFunction)(void*, uint64_t, void const*);
+		typedef void(*ReadFunction)(void*, uint64_t, void*);
+
+		void* interface;
+		WriteFunction writeFunction;
+		ReadFunction readFunction;
+
+		template <SerialiserInterface Interface>
+		Serialiser(Interface& store)
+			: interface(&store),
+			writeFunction([](void* store, uint64_t length, void const* data) { static_cast<Interface*>(store)->writeBytes(length, data); }),
+			readFunction([](void* store, uint64_t length, void* data) { static_cast<Interface*>(store)->readBytes(length, data); })
+		{}
+
+		void writeBytes(uint64_t length, void const* data) { writeFunction(interface, length, data); }
+		void readBytes(uint64_t length, void* data) { readFunction(interface, length, data); }
+	};
+
+	template <typename T, SerialiserInterface Interface> requires std::is_trivially_copyable_v<T>
+	void serialiseWrite(T const& data, Interface& store) { store.writeBytes(sizeof(T), &data); }
+	template <typename T, SerialiserInterface Interface> requires std::is_trivially_copyable_v<T>
+	void serialiseRead(T* data, Interface& store) { store.readBytes(sizeof(T), data); }
 }
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+namespace Vivium {
+	// Set for worker threads only
+	static thread_local JobSystem const* _currentJobSystem = nullptr;
+	static thread_local uint32_t _currentThreadIndex = 0;
+
+	JobSystem::JobSystem(uint32_t threadCount)
+		: pendingJobs(0), queuedJobs(0), nextQueue(0), running(true)
+	{
+		threadCount = std::max(threadCount, 1U);
+
+		for (uint32_t i = 0; i < threadCount; i++) {
+			queues.push_back(std::make_unique<JobQueue>());
+		}
+
+		for (uint32_t i = 0; i < threadCount - 1; i++) {
+			workers.emplace_back(&JobSystem::_workerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		wait();
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			running = false;
+		}
+
+		sleepCondition.notify_all();
+
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	uint32_t JobSystem::getThreadCount() const
+	{
+		return static_cast<uint32_t>(queues.size());
+	}
+
+	uint32_t JobSystem::getThreadIndex() const
+	{
+		if (_currentJobSystem == this) return _currentThreadIndex;
+
+		return getThreadCount() - 1;
+	}
+
+	void JobSystem::submit(Job job)
+	{
+		JobQueue& queue = *queues[nextQueue++ % queues.size()];
+
+		++pendingJobs;
+
+		{
+			// Taken so a worker can't miss the wakeup between checking and sleeping
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			++queuedJobs;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+
+		sleepCondition.notify_one();
+		waitCondition.notify_all();
+	}
+
+	void JobSystem::wait()
+	{
+		Job job;
+
+		while (pendingJobs > 0) {
+			if (_takeJob(queues.size() - 1, job)) {
+				job();
+				_finishJob();
+
+				continue;
+			}
+
+			// Nothing left to take, the last jobs are running elsewhere
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			waitCondition.wait(lock, [this] { return pendingJobs == 0 || queuedJobs > 0; });
+		}
+	}
+
+	bool JobSystem::_takeJob(uint64_t queueIndex, Job& job)
+	{
+		// Newest job from our own queue
+		{
+			JobQueue& queue = *queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+
+			if (!queue.jobs.empty()) {
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+				--queuedJobs;
+
+				return true;
+			}
+		}
+
+		// Steal oldest job from another queue
+		for (uint64_t i = 1; i < queues.size(); i++) {
+			JobQueue& queue = *queues[(queueIndex + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+
+			if (!queue.jobs.empty()) {
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+				--queuedJobs;
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::_finishJob()
+	{
+		if (--pendingJobs != 0) return;
+
+		{
+			// Taken so wait() can't miss the wakeup between checking and sleeping
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+
+		waitCondition.notify_all();
+	}
+
+	void JobSystem::_workerLoop(uint64_t queueIndex)
+	{
+		_currentJobSystem = this;
+		_currentThreadIndex = static_cast<uint32_t>(queueIndex);
+
+		Job job;
+
+		while (true) {
+			if (_takeJob(queueIndex, job)) {
+				job();
+				_finishJob();
+
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepCondition.wait(lock, [this] { return !running || queuedJobs > 0; });
+
+			if (!running) return;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vivium {
+	// Work-stealing thread pool
+	// Each thread owns a queue, and takes its newest job first; idle threads steal the oldest job
+	//	from other queues. The thread calling wait() executes jobs too, so a JobSystem of
+	//	threadCount threads spawns threadCount - 1 workers
+	struct JobSystem {
+		typedef std::function<void()> Job;
+
+		struct JobQueue {
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::thread> workers;
+		// One queue per worker, last queue belongs to the thread calling wait()
+		std::vector<std::unique_ptr<JobQueue>> queues;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		// Wakes wait() once every job has finished, or a job is queued it can take
+		std::condition_variable waitCondition;
+
+		// Submitted but not yet finished
+		std::atomic<uint64_t> pendingJobs;
+		// Submitted but not yet taken from a queue
+		std::atomic<uint64_t> queuedJobs;
+		std::atomic<uint64_t> nextQueue;
+		std::atomic<bool> running;
+
+		JobSystem(uint32_t threadCount = std::thread::hardware_concurrency());
+		~JobSystem();
+
+		JobSystem(JobSystem const&) = delete;
+		JobSystem& operator=(JobSystem const&) = delete;
+
+		uint32_t getThreadCount() const;
+		// Index of the calling thread in [0, getThreadCount()), threads that aren't workers of this
+		//	system share the last index (the one used by wait())
+		uint32_t getThreadIndex() const;
+
+		void submit(Job job);
+		// Blocks until every submitted job has finished, executing jobs in the meantime
+		// Sleeps while the remaining jobs are running on other threads
+		void wait();
+
+		bool _takeJob(uint64_t queueIndex, Job& job);
+		void _finishJob();
+		void _workerLoop(uint64_t queueIndex);
+	};
+}
\ No newline at end of file
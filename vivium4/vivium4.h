@@ -15,6 +15,10 @@
 #include "graphics/gui/visual/entry.h"
 #include "graphics/primitives/framebuffer.h"
 #include "physics/physics.h"
+#include "physics/world.h"
 #include "math/polygon.h"
 #include "math/math.h"
 #include "ecs/registry.h"
+#include "ecs/archetype.h"
+#include "ecs/command_buffer.h"
+#include "serialiser/serialiser.h"